@@ -0,0 +1,80 @@
+/*
+  block_timing.c - Planned versus actual execution time of each planner block
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_BLOCK_TIMING
+
+static block_timing_t timing_buffer[BLOCK_TIMING_SIZE];
+static uint8_t timing_head;   // Index of the next record to write
+static volatile uint8_t timing_count;
+static uint16_t timing_lost;  // Records overwritten since last read
+static uint8_t timing_streaming;
+
+
+void block_timing_record(int32_t line_number, uint32_t planned_usec, uint32_t actual_usec)
+{
+  uint8_t sreg = SREG;
+  cli(); // The stepper ISR runs with interrupts enabled. Keep each record whole.
+  block_timing_t *timing = &timing_buffer[timing_head];
+  timing->line_number = line_number;
+  timing->planned_usec = planned_usec;
+  timing->actual_usec = actual_usec;
+  if (++timing_head == BLOCK_TIMING_SIZE) { timing_head = 0; }
+  if (timing_count < BLOCK_TIMING_SIZE) { timing_count++; }
+  else if (timing_lost < 0xFFFF) { timing_lost++; }
+  SREG = sreg;
+}
+
+
+uint8_t block_timing_pop(block_timing_t *timing)
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t found = (timing_count > 0);
+  if (found) {
+    int16_t tail = (int16_t)timing_head - timing_count;
+    if (tail < 0) { tail += BLOCK_TIMING_SIZE; }
+    memcpy(timing, &timing_buffer[tail], sizeof(block_timing_t));
+    timing_count--;
+  }
+  SREG = sreg;
+  return(found);
+}
+
+
+uint8_t block_timing_count() { return(timing_count); }
+
+
+uint16_t block_timing_take_lost()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t lost = timing_lost;
+  timing_lost = 0;
+  SREG = sreg;
+  return(lost);
+}
+
+
+void block_timing_set_streaming(uint8_t enable) { timing_streaming = enable; }
+
+
+uint8_t block_timing_is_streaming() { return(timing_streaming); }
+
+#endif
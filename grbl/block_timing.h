@@ -0,0 +1,50 @@
+/*
+  block_timing.h - Planned versus actual execution time of each planner block
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef block_timing_h
+#define block_timing_h
+
+#include "grbl.h"
+
+#ifndef BLOCK_TIMING_SIZE
+  #define BLOCK_TIMING_SIZE 16 // Number of blocks kept. Max 255. 12 bytes of RAM each.
+#endif
+
+typedef struct {
+  int32_t line_number;
+  uint32_t planned_usec; // Duration of the velocity profile computed by the segment generator
+  uint32_t actual_usec;  // Time the stepper took to execute it, including any stalls
+} block_timing_t;
+
+// Stores the timing of a completed block, overwriting the oldest once full. Called by the stepper ISR.
+void block_timing_record(int32_t line_number, uint32_t planned_usec, uint32_t actual_usec);
+
+// Removes the oldest block and copies it to the given record. Returns false if there is none.
+uint8_t block_timing_pop(block_timing_t *timing);
+
+// Returns the number of blocks held.
+uint8_t block_timing_count();
+
+// Returns the number of blocks overwritten before they could be read, and clears it.
+uint16_t block_timing_take_lost();
+
+// Enables or disables streaming of each block's timing as it completes.
+void block_timing_set_streaming(uint8_t enable);
+uint8_t block_timing_is_streaming();
+
+#endif
@@ -34,8 +34,12 @@
 // NOTE: OEMs can avoid the need to maintain/update the defaults.h and cpu_map.h files and use only
 // one configuration file by placing their specific defaults and pin map at the bottom of this file.
 // If doing so, simply comment out these two defines and see instructions below.
-#define DEFAULTS_GENERIC
-#define CPU_MAP_2560_INITIAL
+// The board may also be selected on the compiler command line, as the host simulator's step trace
+// tests do: -DDEFAULTS_RAMPS_BOARD -DCPU_MAP_2560_RAMPS_BOARD
+#if !defined(DEFAULTS_RAMPS_BOARD) && !defined(CPU_MAP_2560_RAMPS_BOARD)
+  #define DEFAULTS_GENERIC
+  #define CPU_MAP_2560_INITIAL
+#endif
 
 // To use with RAMPS 1.4 Board, comment out the above defines and uncomment the next two defines
 // #define DEFAULTS_RAMPS_BOARD
@@ -239,6 +243,48 @@
 // Enables code for debugging purposes. Not for general use and always in constant flux.
 // #define DEBUG // Uncomment to enable. Default disabled.
 
+// Profiles the Stepper Driver Interrupt with a free-running Timer5 at the full CPU clock. The
+// min/avg/max CPU cycles spent per ISR tick are reported, and then restarted, in the DEBUG report
+// sent with the CMD_DEBUG_REPORT realtime command. Ticks that load a new step segment are kept
+// apart from plain Bresenham ticks. Times include any interrupts serviced during the ISR. Use it
+// to find the maximum step rate of a configuration. Requires DEBUG.
+// NOTE: Timer5 is shared with the cycle clock and with STEP_PULSE_OUTPUT_COMPARE, which all run it
+// free at the full CPU clock. Its TCCR5A is only cleared at init, before st_reset() sets the compare
+// output modes. Any later write of TCCR5A must keep step_oc_idle_mode, or the step pins stop idling.
+// #define DEBUG_STEPPER_ISR_PROFILE // Default disabled. Uncomment to enable.
+
+// Keeps histograms of how long the main program takes per protocol_main_loop() iteration and in each
+// of its major stages: g-code parsing (planning included), planning, segment preparation and status
+// reports. Time spent waiting on the stepper, like a full planner buffer or a buffer sync, is not
+// counted. The '$L' command prints the histograms and '$LR' clears them, e.g. before a job. Shows which
+// stage limits the short line segments per second Grbl can sustain. Uses free-running Timer5, which
+// may be shared with DEBUG_STEPPER_ISR_PROFILE, and costs a little CPU time and ~200 bytes of RAM.
+// #define ENABLE_MAIN_LOOP_PROFILE // Default disabled. Uncomment to enable.
+
+// Keeps the last EVENT_TRACE_SIZE system events in a ring buffer, each with a microsecond timestamp:
+// planner blocks loaded and discarded, segment buffer underruns, overrides, feed holds, cycle starts
+// and stops, alarms like a limit trip, serial RX overflows and EEPROM writes. The '$T' command dumps
+// and clears it, e.g. after a stutter or an alarm. Cheap enough to leave enabled on a production
+// machine. Uses free-running Timer5, shared with the profiling options, and 10 bytes of RAM per event.
+// #define ENABLE_EVENT_TRACE // Default disabled. Uncomment to enable.
+// #define EVENT_TRACE_SIZE 64 // Uncomment to override default in event_trace.h.
+
+// Times the execution of every planner block and compares it with the duration of the velocity
+// profile computed by the segment generator. Blocks that take longer than planned were held up by
+// segment buffer underruns, i.e. by a busy main program or a slow stream. The '$B' command prints
+// and clears the timing of the last BLOCK_TIMING_SIZE blocks, keyed by g-code line number ('N').
+// '$B=1' streams each block's timing as it completes and '$B=0' stops it. Uses free-running Timer5,
+// shared with the profiling options, and ~200 bytes of RAM.
+// #define ENABLE_BLOCK_TIMING // Default disabled. Uncomment to enable.
+// #define BLOCK_TIMING_SIZE 16 // Uncomment to override default in block_timing.h.
+
+// Paints all free SRAM at power-up, so the deepest the stack has ever reached can be found later.
+// The '$M' command reports the SRAM used by the static variables and by the large buffers of each
+// subsystem, along with the free SRAM now and at the stack high-water mark. Use it when raising
+// BLOCK_BUFFER_SIZE, RX_BUFFER_SIZE or LINE_BUFFER_SIZE, to keep a safe margin between the stack
+// and the static variables. AVR only. Not supported by the host simulator.
+// #define ENABLE_SRAM_REPORT // Default disabled. Uncomment to enable.
+
 // Configure rapid, feed, and spindle override settings. These values define the max and min
 // allowable override values and the coarse and fine increments per command received. Please
 // note the allowable values in the descriptions following each define.
@@ -277,6 +323,26 @@
 #define REPORT_FIELD_OVERRIDES // Default enabled. Comment to disable.
 #define REPORT_FIELD_LINE_NUMBERS // Default enabled. Comment to disable.
 
+// Adds a segment buffer state field 'Sg:' to the status report for diagnosing stutters in a job. The
+// first value is the lowest step segment buffer fill seen in the current job while planner blocks
+// were still queued, and the second is the number of times the segment buffer ran empty under those
+// conditions, which stops the machine mid-cut. A low fill with a full planner buffer points to the
+// main program being too slow to prepare segments, rather than to the host streaming too slowly.
+// #define REPORT_FIELD_SEGMENT_BUFFER_STATE // Default disabled. Uncomment to enable.
+
+// Adds a buffered time field 'Bt:' to the status report. It is the estimated time in milliseconds
+// that the motions in the planner buffer take to execute, at the nominal speeds they were planned
+// with. Blocks range from a fraction of a mm to the full machine travel, so a host that keeps a
+// target time queued, rather than a number of blocks, keeps the machine from starving on programs
+// that mix fine and coarse motions. The estimate is kept up to date as blocks are added and
+// executed, and ignores acceleration and later override changes.
+// #define REPORT_FIELD_BUFFER_TIME // Default disabled. Uncomment to enable.
+
+// Appends the buffered time of REPORT_FIELD_BUFFER_TIME to every 'ok' response as 'ok:1234', so a
+// streaming host knows it with each acknowledged line, without polling status reports. Senders
+// that compare responses to 'ok' exactly will not recognize it. Requires REPORT_FIELD_BUFFER_TIME.
+// #define REPORT_OK_BUFFER_TIME // Default disabled. Uncomment to enable.
+
 // Some status report data isn't necessary for realtime, only intermittently, because the values don't
 // change often. The following macros configures how many times a status report needs to be called before
 // the associated data is refreshed and included in the status report. However, if one of these value
@@ -305,7 +371,42 @@
 // frequencies below 10kHz, where the aliasing between axes of multi-axis motions can cause audible
 // noise and shake your machine. At even lower step frequencies, AMASS adapts and provides even better
 // step smoothing. See stepper.c for more details on the AMASS system works.
-#define ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING  // Default enabled. Comment to disable.
+// NOTE: -DDISABLE_ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING on the compiler command line also disables it.
+#ifndef DISABLE_ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+  #define ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING  // Default enabled. Comment to disable.
+#endif
+
+// The Stepper Driver Interrupt normally counts every step into the 32-bit machine position, along
+// with a test of the step direction. With this option, it only counts the steps of each axis in
+// 16 bits, and adds them to the machine position with their direction when a step segment ends or
+// the steppers stop. This shortens every ISR tick that steps and raises the maximum step rate. The
+// status report and the probe read the position with the steps of the executing segment included,
+// so they see the same position as before.
+// #define STEPPER_DEFERRED_POSITION // Default disabled. Uncomment to enable.
+
+// Moves the Bresenham line tracer out of the Stepper Driver Interrupt. The main program computes the
+// step bits of every ISR tick of a segment when it preps the segment, and stores them in a ring
+// buffer of step patterns, one byte per tick. The ISR then only writes the next byte to the step
+// port, so it takes the same short time on every tick. The steps are the same as without this option.
+// Requires STEPPER_DEFERRED_POSITION. The status report and the probe count the steps of the executing
+// segment from its patterns. The pattern buffer costs STEP_PATTERN_BUFFER_SIZE bytes of RAM and must
+// hold two segments at the maximum step rate, i.e. twice MAX_STEP_RATE_HZ (30kHz if not set, at least
+// 16kHz with AMASS) divided by ACCELERATION_TICKS_PER_SECOND. Segment prep waits for room in it, and
+// shortens the segments of a block that would take more than half of it.
+// #define STEPPER_STEP_PATTERNS // Default disabled. Uncomment to enable.
+// #define STEP_PATTERN_BUFFER_SIZE 1024 // Uncomment to override default in stepper.h.
+
+// Runs the segment generator of st_prep_buffer() in fixed-point arithmetic. Positions are counted in
+// 1/256 steps from the end of the block, speeds in steps per segment and times in CPU cycles, so a
+// full segment of a ramp or cruise costs a few integer additions, and the steps and the step rate of
+// each segment come from integer rounding and one integer division instead of float math. Only the
+// velocity profile of each block and the partial segments at ramp junctions are still computed in
+// float. The steps of each block are the same, and total times agree with the float path within a
+// few thousandths of a percent. Most step edges move by a few thousand CPU cycles at most. A step
+// that falls right on the end of a segment can move by up to one step interval, since float
+// round-off may leave it to the next segment. Not available with S_CURVE_ACCELERATION. Line motions
+// of more than 8 million steps along an axis are split into several blocks.
+// #define STEPPER_FIXED_POINT_PREP // Default disabled. Uncomment to enable.
 
 // Sets the maximum step rate allowed to be written as a Grbl setting. This option enables an error
 // check in the settings module to prevent settings values that will exceed this limitation. The maximum
@@ -411,13 +512,79 @@
 // values for certain setups have ranged from 5 to 20us.
 // #define STEP_PULSE_DELAY 10 // Step pulse delay in microseconds. Default disabled.
 
+// Ends the step pulses in hardware, with the output compare units of Timer5, instead of with the
+// Stepper Port Reset Interrupt. The Stepper Driver Interrupt forces the step pins to their pulse
+// levels, and Timer5 returns them to idle when the pulse time has passed, so each step costs one
+// interrupt instead of two. Timer5 otherwise keeps running as the free-running cycle clock.
+// NOTE: Moves the step pins to the Timer5 output compare pins, X to Digital Pin 46 (OC5A), Y to
+// Digital Pin 45 (OC5B) and Z to Digital Pin 44 (OC5C). Not available with the RAMPS board, which
+// has the X and Y step pins elsewhere, or with STEP_PULSE_DELAY.
+// #define STEP_PULSE_OUTPUT_COMPARE // Default disabled. Uncomment to enable.
+
 // The number of linear motions in the planner buffer to be planned at any give time. The vast
 // majority of RAM that Grbl uses is based on this buffer size. Only increase if there is extra 
 // available RAM, like when re-compiling for a Mega or Sanguino. Or decrease if the Arduino
 // begins to crash due to the lack of available RAM or if the CPU is having trouble keeping
-// up with planning new incoming motions as they are executed. 
+// up with planning new incoming motions as they are executed. Buffers of more than 255 blocks use
+// 16-bit buffer indices and need external SRAM, at roughly 60 bytes per block.
+// NOTE: Buffers of more than 255 blocks also require PLANNER_RECALCULATE_LIMIT. Without it, the
+// planner may re-plan most of the buffer for each new block, and the time to accept a block grows
+// with the buffer size.
 // #define BLOCK_BUFFER_SIZE 36  // Uncomment to override default in planner.h.
 
+// Stores the step counts, line number, rates and spindle speed of each planner block in 24-bit
+// fixed point, which saves 11 bytes per block and fits about a quarter more blocks in the same
+// RAM. The lookahead speeds and distances stay full precision floats. Step counts are limited to
+// 16,777,215 per axis and block, which the step segment generator could not resolve beyond
+// anyway. Rates and spindle speeds are limited to 65535.99 mm/min and rpm, in steps of 1/256.
+// #define COMPACT_PLANNER_BLOCK // Default disabled. Uncomment to enable.
+
+// Limits the number of blocks the planner re-plans for each new block. With many short segments the
+// plan is rarely optimal, and every new block can re-plan most of the buffer, so the time to accept
+// a block grows with BLOCK_BUFFER_SIZE. With this limit, blocks beyond it keep their previous entry
+// speeds, which can always decelerate to a stop and are safe, and are re-planned later while the main
+// loop waits on a full buffer or for serial data. The plan may be briefly slower than optimal.
+// #define PLANNER_RECALCULATE_LIMIT 16 // Default disabled. Uncomment to enable.
+
+// Applies feed and rapid override changes to the planner blocks as the re-plan reaches them, rather
+// than recomputing the speed limits of the whole buffer at once. Each change then costs one re-plan
+// pass instead of two. With PLANNER_RECALCULATE_LIMIT, the re-plan is bounded and spread over the
+// main loop as well, so turning an override knob no longer stalls it in proportion to the buffer
+// size. The stepper still responds to a change immediately.
+// #define PLANNER_LAZY_OVERRIDES // Default disabled. Uncomment to enable.
+
+// Merges nearly collinear line motions into the last queued planner block, when the merged line
+// stays within this distance (mm) of every junction it replaces. CAM programs with many tiny segments
+// then fill the look-ahead buffer with fewer, longer blocks, which plan faster and let the machine
+// reach higher speeds. Only motions with the same feed rate, spindle speed and step directions merge.
+// The tolerance adds to the path deviation of the CAM output, so keep it well below the part tolerance.
+// #define PLANNER_COALESCE_TOLERANCE 0.005 // Default disabled. Uncomment to enable.
+
+// Limits the junction speeds by the curvature of the path over this many junctions, so that the
+// centripetal acceleration stays within the axis acceleration settings. Curves made of many short
+// lines are then run at the steady speed their radius allows. Junction deviation alone only sees
+// each junction angle, which lets dense segments pass faster than the curve they trace and speed up
+// and slow down with the CAM point spacing. The limit never raises a junction speed. Larger windows
+// even out more segment noise, at 4 bytes of RAM per axis and block.
+// #define PLANNER_CURVATURE_WINDOW 4 // Default disabled. Uncomment to enable.
+
+// Executes every acceleration and deceleration ramp as a jerk-limited S-curve, instead of at
+// constant acceleration. The acceleration rises and falls at the axis jerk settings ($140-$142,
+// mm/sec^3) and is zero at both ends of each ramp, so machines can run higher accelerations without
+// ringing. The planner plans with the same ramps. Ramps take longer than at constant acceleration,
+// about accel/jerk per ramp, and the profile of each block costs more to compute. Acceleration
+// ramps don't continue across blocks, so combine this with PLANNER_COALESCE_TOLERANCE for programs
+// with many short lines. Enabling or disabling it restores the default settings.
+// #define S_CURVE_ACCELERATION // Default disabled. Uncomment to enable.
+
+// Enables the G64 continuous path control mode. Under G64 P<tolerance>, each corner between two G1
+// lines is rounded by a short arc that stays within the tolerance of the programmed corner, so the
+// machine keeps more speed through it than the junction deviation ($11) allows. The arc is traced
+// in segments within the arc tolerance ($12) and is only inserted where it is faster than the plain
+// corner. G64 without a P word uses the tolerance (mm) defined here. G61, the default, and G64 P0
+// trace the exact path. Not supported with COREXY.
+// #define PATH_BLENDING 0.02 // Default disabled. Uncomment to enable.
+
 // Governs the size of the intermediary step segment buffer between the step execution algorithm
 // and the planner blocks. Each segment is set of steps executed at a constant velocity over a
 // fixed time defined by ACCELERATION_TICKS_PER_SECOND. They are computed such that the planner
@@ -33,12 +33,22 @@
   #define SERIAL_UDRE USART0_UDRE_vect
 
   // Define step pulse output pins. NOTE: All step bit pins must be on the same port.
-  #define STEP_DDR      DDRA
-  #define STEP_PORT     PORTA
-  #define STEP_PIN      PINA
-  #define X_STEP_BIT    2 // MEGA2560 Digital Pin 24
-  #define Y_STEP_BIT    3 // MEGA2560 Digital Pin 25
-  #define Z_STEP_BIT    4 // MEGA2560 Digital Pin 26
+  #ifdef STEP_PULSE_OUTPUT_COMPARE
+    // Timer5 output compare pins, in OC5A, OC5B, OC5C order. See stepper.c.
+    #define STEP_DDR      DDRL
+    #define STEP_PORT     PORTL
+    #define STEP_PIN      PINL
+    #define X_STEP_BIT    3 // MEGA2560 Digital Pin 46 (OC5A)
+    #define Y_STEP_BIT    4 // MEGA2560 Digital Pin 45 (OC5B)
+    #define Z_STEP_BIT    5 // MEGA2560 Digital Pin 44 (OC5C)
+  #else
+    #define STEP_DDR      DDRA
+    #define STEP_PORT     PORTA
+    #define STEP_PIN      PINA
+    #define X_STEP_BIT    2 // MEGA2560 Digital Pin 24
+    #define Y_STEP_BIT    3 // MEGA2560 Digital Pin 25
+    #define Z_STEP_BIT    4 // MEGA2560 Digital Pin 26
+  #endif
   #define STEP_MASK ((1<<X_STEP_BIT)|(1<<Y_STEP_BIT)|(1<<Z_STEP_BIT)) // All step bits
 
   // Define step direction output pins. NOTE: All direction pins must be on the same port.
@@ -161,6 +171,9 @@
   #define _STEP_PORT(i) _PORT(STEP_PORT_##i)
   #define STEP_PORT(i) _STEP_PORT(i)
   #define STEP_PIN(i) _PIN(STEP_PORT_##i)
+  // The lowest axis with its step pin on the same port. The stepper ISR writes each port once.
+  // Derived from the port addresses, which the compiler folds to a constant.
+  #define STEP_PORT_GROUP(i) ((&STEP_PORT(i) == &STEP_PORT(0)) ? 0 : ((&STEP_PORT(i) == &STEP_PORT(1)) ? 1 : 2))
 
   // Define step direction output pins.
   #define DIRECTION_PORT_0 F
@@ -175,6 +188,9 @@
   #define _DIRECTION_PORT(i) _PORT(DIRECTION_PORT_##i)
   #define DIRECTION_PORT(i) _DIRECTION_PORT(i)
   #define DIRECTION_PIN(i) _PIN(DIRECTION_PORT_##i)
+  // The lowest axis with its direction pin on the same port.
+  #define DIRECTION_PORT_GROUP(i) ((&DIRECTION_PORT(i) == &DIRECTION_PORT(0)) ? 0 : \
+                                   ((&DIRECTION_PORT(i) == &DIRECTION_PORT(1)) ? 1 : 2))
 
   // Define stepper driver enable/disable output pin.
   #define STEPPER_DISABLE_PORT_0 D
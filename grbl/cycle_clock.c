@@ -0,0 +1,68 @@
+/*
+  cycle_clock.c - Free-running CPU cycle clock for profiling and event tracing
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#if defined(ENABLE_MAIN_LOOP_PROFILE) || defined(ENABLE_EVENT_TRACE) || defined(ENABLE_BLOCK_TIMING)
+
+#define CYCLE_CLOCK_TICKS_PER_USEC (F_CPU/1000000)
+
+static volatile uint32_t timer_overflows; // Counts above the 16-bit timer
+
+
+void cycle_clock_init()
+{
+  // Configure Timer 5: Free-running clock. Normal mode, no prescaler. Wraps every 4.1msec.
+  TCCR5A = 0;
+  TCCR5B = (1<<CS50);
+  TIMSK5 |= (1<<TOIE5); // Enable timer overflow interrupt to extend the clock.
+}
+
+
+// Reads the timer and its overflow count as one consistent value.
+static uint16_t cycle_clock_read(uint32_t *overflows)
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t count = TCNT5;
+  *overflows = timer_overflows;
+  if ((TIFR5 & (1<<TOV5)) && (count < 0x8000)) { (*overflows)++; } // Overflow not yet serviced.
+  SREG = sreg;
+  return(count);
+}
+
+
+uint32_t cycle_clock_cycles()
+{
+  uint32_t overflows;
+  uint16_t count = cycle_clock_read(&overflows);
+  return((overflows << 16) | count);
+}
+
+
+uint32_t cycle_clock_usec()
+{
+  uint32_t overflows;
+  uint16_t count = cycle_clock_read(&overflows);
+  return(overflows*(0x10000/CYCLE_CLOCK_TICKS_PER_USEC) + count/CYCLE_CLOCK_TICKS_PER_USEC);
+}
+
+
+ISR(TIMER5_OVF_vect) { timer_overflows++; }
+
+#endif
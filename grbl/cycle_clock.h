@@ -0,0 +1,33 @@
+/*
+  cycle_clock.h - Free-running CPU cycle clock for profiling and event tracing
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef cycle_clock_h
+#define cycle_clock_h
+
+#include "grbl.h"
+
+// Starts the clock on Timer5. Used by ENABLE_MAIN_LOOP_PROFILE, ENABLE_EVENT_TRACE and ENABLE_BLOCK_TIMING.
+void cycle_clock_init();
+
+// Returns the CPU cycle count since the clock was started. Wraps after 268sec.
+uint32_t cycle_clock_cycles();
+
+// Returns the time since the clock was started in microseconds. Wraps after 71.6min.
+uint32_t cycle_clock_usec();
+
+#endif
@@ -495,4 +495,17 @@
   #define DEFAULT_HOMING_PULLOFF 1.0 // mm
 #endif
 
+#ifdef S_CURVE_ACCELERATION
+  // Machine defaults without jerk settings reach full acceleration in 50msec.
+  #ifndef DEFAULT_X_JERK
+    #define DEFAULT_X_JERK (20.0*60.0*DEFAULT_X_ACCELERATION) // mm/min^3
+  #endif
+  #ifndef DEFAULT_Y_JERK
+    #define DEFAULT_Y_JERK (20.0*60.0*DEFAULT_Y_ACCELERATION) // mm/min^3
+  #endif
+  #ifndef DEFAULT_Z_JERK
+    #define DEFAULT_Z_JERK (20.0*60.0*DEFAULT_Z_ACCELERATION) // mm/min^3
+  #endif
+#endif
+
 #endif
\ No newline at end of file
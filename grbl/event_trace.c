@@ -0,0 +1,74 @@
+/*
+  event_trace.c - Ring buffer of timestamped system events for post-mortem diagnosis
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_EVENT_TRACE
+
+static event_t event_buffer[EVENT_TRACE_SIZE];
+static uint8_t event_head;   // Index of the next event to write
+static uint8_t event_count;
+static uint16_t event_lost;  // Events overwritten since the last dump
+
+
+void event_trace_record(uint8_t type, uint8_t arg, uint32_t data)
+{
+  uint8_t sreg = SREG;
+  cli(); // May be called from interrupts. Keep each event whole.
+  event_t *event = &event_buffer[event_head];
+  event->usec = cycle_clock_usec();
+  event->type = type;
+  event->arg = arg;
+  event->data = data;
+  if (++event_head == EVENT_TRACE_SIZE) { event_head = 0; }
+  if (event_count < EVENT_TRACE_SIZE) { event_count++; }
+  else if (event_lost < 0xFFFF) { event_lost++; }
+  SREG = sreg;
+}
+
+
+uint8_t event_trace_pop(event_t *event)
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t found = (event_count > 0);
+  if (found) {
+    int16_t tail = (int16_t)event_head - event_count;
+    if (tail < 0) { tail += EVENT_TRACE_SIZE; }
+    memcpy(event, &event_buffer[tail], sizeof(event_t));
+    event_count--;
+  }
+  SREG = sreg;
+  return(found);
+}
+
+
+uint8_t event_trace_count() { return(event_count); }
+
+
+uint16_t event_trace_take_lost()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t lost = event_lost;
+  event_lost = 0;
+  SREG = sreg;
+  return(lost);
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*
+  event_trace.h - Ring buffer of timestamped system events for post-mortem diagnosis
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef event_trace_h
+#define event_trace_h
+
+#include "grbl.h"
+
+#ifndef EVENT_TRACE_SIZE
+  #define EVENT_TRACE_SIZE 64 // Number of events kept. Max 255. 10 bytes of RAM each.
+#endif
+
+// Event types, with the meaning of their arg and data values.
+#define EVENT_BLOCK_LOAD        0 // Segment generator started a planner block. Data: line number
+#define EVENT_BLOCK_DISCARD     1 // Planner block completed. Data: line number
+#define EVENT_SEGMENT_UNDERRUN  2 // Stepper ran out of segments while planner blocks remained
+#define EVENT_CYCLE_START       3 // Cycle started or resumed
+#define EVENT_CYCLE_STOP        4 // Cycle completed or came to a hold
+#define EVENT_HOLD              5 // Hold initiated. Arg: EXEC_FEED_HOLD, EXEC_MOTION_CANCEL, etc. flags
+#define EVENT_FEED_OVERRIDE     6 // Data: new feed override percent
+#define EVENT_RAPID_OVERRIDE    7 // Data: new rapid override percent
+#define EVENT_SPINDLE_OVERRIDE  8 // Data: new spindle override percent
+#define EVENT_ALARM             9 // Arg: alarm code, e.g. EXEC_ALARM_HARD_LIMIT for a limit trip
+#define EVENT_SERIAL_OVERFLOW  10 // Byte dropped by a full RX buffer. Data: the byte
+#define EVENT_EEPROM_WRITE     11 // Arg: bytes written. Data: EEPROM address
+
+typedef struct {
+  uint32_t usec; // cycle_clock_usec() at the time of the event
+  uint8_t type;
+  uint8_t arg;
+  uint32_t data; // Holds a full line number
+} event_t;
+
+// Appends an event, overwriting the oldest once the buffer is full. Safe to call from interrupts.
+void event_trace_record(uint8_t type, uint8_t arg, uint32_t data);
+
+// Removes the oldest event and copies it to the given event. Returns false if there is none.
+uint8_t event_trace_pop(event_t *event);
+
+// Returns the number of events held, and the number overwritten before they could be read. Reading
+// the lost count clears it.
+uint8_t event_trace_count();
+uint16_t event_trace_take_lost();
+
+#endif
@@ -78,6 +78,9 @@ uint8_t gc_execute_line(char *line)
   uint8_t axis_command = AXIS_COMMAND_NONE;
   uint8_t axis_0, axis_1, axis_linear;
   uint8_t coord_select = 0; // Tracks G10 P coordinate selection for execution
+  #ifdef PATH_BLENDING
+    float path_tolerance = 0.0; // Tracks G64 P path tolerance for execution
+  #endif
 
   // Initialize bitflag tracking variables for axis indices compatible operations.
   uint8_t axis_words = 0; // XYZ tracking
@@ -226,8 +229,18 @@ uint8_t gc_execute_line(char *line)
           case 61:
             word_bit = MODAL_GROUP_G13;
             if (mantissa != 0) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G61.1 not supported]
-            // gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+            #ifdef PATH_BLENDING
+              gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+            #else
+              // gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+            #endif
             break;
+          #ifdef PATH_BLENDING
+            case 64:
+              word_bit = MODAL_GROUP_G13;
+              gc_block.modal.control = CONTROL_MODE_CONTINUOUS; // G64
+              break;
+          #endif
           default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G command]
         }
         if (mantissa > 0) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [Unsupported or invalid Gxx.x command]
@@ -502,7 +515,20 @@ uint8_t gc_execute_line(char *line)
     }
   }
 
-  // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+  #ifdef PATH_BLENDING
+    // [16. Set path control mode ]: G61.1 NOT SUPPORTED. G64 takes its path tolerance from an optional
+    // P word, unless a G10 in the same block needs it. A dwell has already removed its P word.
+    if (bit_istrue(command_words,bit(MODAL_GROUP_G13)) && (gc_block.modal.control == CONTROL_MODE_CONTINUOUS)) {
+      path_tolerance = PATH_BLENDING;
+      if (bit_istrue(value_words,bit(WORD_P)) && (gc_block.non_modal_command != NON_MODAL_SET_COORDINATE_DATA)) {
+        path_tolerance = gc_block.values.p;
+        if (gc_block.modal.units == UNITS_MODE_INCHES) { path_tolerance *= MM_PER_INCH; }
+        bit_false(value_words,bit(WORD_P));
+      }
+    }
+  #else
+    // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+  #endif
   // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
   // [18. Set retract mode ]: NOT SUPPORTED.
 
@@ -985,8 +1011,15 @@ uint8_t gc_execute_line(char *line)
     system_flag_wco_change();
   }
 
-  // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
-  // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+  // [16. Set path control mode ]: G61.1 NOT SUPPORTED. G64 only with PATH_BLENDING.
+  #ifdef PATH_BLENDING
+    if (bit_istrue(command_words,bit(MODAL_GROUP_G13))) {
+      gc_state.modal.control = gc_block.modal.control;
+      gc_state.path_tolerance = path_tolerance; // Zero for G61.
+    }
+  #else
+    // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+  #endif
 
   // [17. Set distance mode ]:
   gc_state.modal.distance = gc_block.modal.distance;
@@ -1036,6 +1069,10 @@ uint8_t gc_execute_line(char *line)
     if (axis_command == AXIS_COMMAND_MOTION_MODE) {
       uint8_t gc_update_pos = GC_UPDATE_POS_TARGET;
       if (gc_state.modal.motion == MOTION_MODE_LINEAR) {
+        #ifdef PATH_BLENDING
+          // Blend only the corners between G1 lines. Inverse time feed rates are kept exact.
+          if (!(pl_data->condition & PL_COND_FLAG_INVERSE_TIME)) { pl_data->path_tolerance = gc_state.path_tolerance; }
+        #endif
         mc_line(gc_block.values.xyz, pl_data);
       } else if (gc_state.modal.motion == MOTION_MODE_SEEK) {
         pl_data->condition |= PL_COND_FLAG_RAPID_MOTION; // Set rapid motion condition flag.
@@ -1141,5 +1178,5 @@ uint8_t gc_execute_line(char *line)
    group 8 = {M7*} enable mist coolant (* Compile-option)
    group 9 = {M48, M49, M56*} enable/disable override switches (* Compile-option)
    group 10 = {G98, G99} return mode canned cycles
-   group 13 = {G61.1, G64} path control mode (G61 is supported)
+   group 13 = {G61.1, G64*} path control mode (G61 is supported)
 */
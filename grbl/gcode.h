@@ -39,7 +39,7 @@
 #define MODAL_GROUP_G7 7 // [G40] Cutter radius compensation mode. G41/42 NOT SUPPORTED.
 #define MODAL_GROUP_G8 8 // [G43.1,G49] Tool length offset
 #define MODAL_GROUP_G12 9 // [G54,G55,G56,G57,G58,G59] Coordinate system selection
-#define MODAL_GROUP_G13 10 // [G61] Control mode
+#define MODAL_GROUP_G13 10 // [G61,G64] Control mode
 
 #define MODAL_GROUP_M4 11  // [M0,M1,M2,M30] Stopping
 #define MODAL_GROUP_M7 12 // [M3,M4,M5] Spindle turning
@@ -108,6 +108,7 @@
 
 // Modal Group G13: Control mode
 #define CONTROL_MODE_EXACT_PATH 0 // G61 (Default: Must be zero)
+#define CONTROL_MODE_CONTINUOUS 1 // G64
 
 // Modal Group M7: Spindle control
 #define SPINDLE_DISABLE 0 // M5 (Default: Must be zero)
@@ -189,7 +190,11 @@ typedef struct {
   // uint8_t cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
   uint8_t tool_length;     // {G43.1,G49}
   uint8_t coord_select;    // {G54,G55,G56,G57,G58,G59}
-  // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
+  #ifdef PATH_BLENDING
+    uint8_t control;       // {G61,G64}
+  #else
+    // uint8_t control;    // {G61} NOTE: Don't track. Only default supported.
+  #endif
   uint8_t program_flow;    // {M0,M1,M2,M30}
   uint8_t coolant;         // {M7,M8,M9}
   uint8_t spindle;         // {M3,M4,M5}
@@ -225,6 +230,9 @@ typedef struct {
   float coord_offset[N_AXIS];    // Retains the G92 coordinate offset (work coordinates) relative to
                                  // machine zero in mm. Non-persistent. Cleared upon reset and boot.
   float tool_length_offset;      // Tracks tool length offset value when enabled.
+  #ifdef PATH_BLENDING
+    float path_tolerance;        // G64 P path blending tolerance in mm. Zero traces the exact path.
+  #endif
 } parser_state_t;
 extern parser_state_t gc_state;
 
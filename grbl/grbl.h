@@ -61,6 +61,11 @@
 #include "stepper.h"
 #include "jog.h"
 #include "sleep.h"
+#include "cycle_clock.h"
+#include "latency.h"
+#include "event_trace.h"
+#include "block_timing.h"
+#include "sram.h"
 
 // ---------------------------------------------------------------------------------------
 // COMPILE-TIME ERROR CHECKING OF DEFINE VALUES:
@@ -87,6 +92,65 @@
   #endif
 #endif
 
+#if defined(DEBUG_STEPPER_ISR_PROFILE)
+  #if !defined(DEBUG)
+    #error "DEBUG_STEPPER_ISR_PROFILE must be enabled with DEBUG."
+  #endif
+#endif
+
+#if defined(ENABLE_EVENT_TRACE) && ((EVENT_TRACE_SIZE < 1) || (EVENT_TRACE_SIZE > 255))
+  #error "EVENT_TRACE_SIZE must be between 1 and 255."
+#endif
+
+#if defined(ENABLE_BLOCK_TIMING) && ((BLOCK_TIMING_SIZE < 1) || (BLOCK_TIMING_SIZE > 255))
+  #error "BLOCK_TIMING_SIZE must be between 1 and 255."
+#endif
+
+#if (BLOCK_BUFFER_SIZE > 255) && !defined(PLANNER_RECALCULATE_LIMIT)
+  #error "BLOCK_BUFFER_SIZE above 255 requires PLANNER_RECALCULATE_LIMIT."
+#endif
+
+#if defined(PLANNER_RECALCULATE_LIMIT) && ((PLANNER_RECALCULATE_LIMIT < 1) || (PLANNER_RECALCULATE_LIMIT >= BLOCK_BUFFER_SIZE))
+  #error "PLANNER_RECALCULATE_LIMIT must be between 1 and BLOCK_BUFFER_SIZE-1."
+#endif
+
+#if defined(REPORT_OK_BUFFER_TIME) && !defined(REPORT_FIELD_BUFFER_TIME)
+  #error "REPORT_OK_BUFFER_TIME requires REPORT_FIELD_BUFFER_TIME."
+#endif
+
+#if defined(PLANNER_CURVATURE_WINDOW) && ((PLANNER_CURVATURE_WINDOW < 2) || (PLANNER_CURVATURE_WINDOW > 255))
+  #error "PLANNER_CURVATURE_WINDOW must be between 2 and 255."
+#endif
+
+#if defined(STEPPER_STEP_PATTERNS) && !defined(STEPPER_DEFERRED_POSITION)
+  #error "STEPPER_STEP_PATTERNS requires STEPPER_DEFERRED_POSITION."
+#endif
+
+#if defined(STEPPER_STEP_PATTERNS) && ((STEP_PATTERN_BUFFER_SIZE < (2*STEP_PATTERN_MAX_TICK_RATE)/ACCELERATION_TICKS_PER_SECOND) || \
+    (STEP_PATTERN_BUFFER_SIZE > 32768))
+  #error "STEP_PATTERN_BUFFER_SIZE must hold two segments at the maximum step rate, and at most 32768 ticks."
+#endif
+
+#if defined(STEPPER_STEP_PATTERNS) && defined(DEFAULTS_RAMPS_BOARD)
+  #if (STEP_BIT_0 == STEP_BIT_1) || (STEP_BIT_0 == STEP_BIT_2) || (STEP_BIT_1 == STEP_BIT_2)
+    #error "STEPPER_STEP_PATTERNS requires a different step bit for each axis."
+  #endif
+#endif
+
+#if defined(STEPPER_FIXED_POINT_PREP) && defined(S_CURVE_ACCELERATION)
+  #error "STEPPER_FIXED_POINT_PREP is not supported with S_CURVE_ACCELERATION."
+#endif
+
+#if defined(STEP_PULSE_OUTPUT_COMPARE) && (defined(DEFAULTS_RAMPS_BOARD) || defined(STEP_PULSE_DELAY))
+  #error "STEP_PULSE_OUTPUT_COMPARE is not supported with the RAMPS board or STEP_PULSE_DELAY."
+#elif defined(STEP_PULSE_OUTPUT_COMPARE) && ((X_STEP_BIT != 3) || (Y_STEP_BIT != 4) || (Z_STEP_BIT != 5))
+  #error "STEP_PULSE_OUTPUT_COMPARE requires the X, Y and Z step pins on OC5A, OC5B and OC5C."
+#endif
+
+#if defined(PATH_BLENDING) && defined(COREXY)
+  #error "PATH_BLENDING is not supported with COREXY."
+#endif
+
 #if (REPORT_WCO_REFRESH_BUSY_COUNT < REPORT_WCO_REFRESH_IDLE_COUNT)
   #error "WCO busy refresh is less than idle refresh."
 #endif
@@ -0,0 +1,61 @@
+/*
+  latency.c - Main loop latency profiling
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_MAIN_LOOP_PROFILE
+
+static latency_histogram_t histogram[LATENCY_N_STAGE];
+static uint32_t paused_cycles; // Total time excluded by latency_pause()
+static uint32_t pause_start;
+
+
+void latency_init() { latency_reset(); }
+
+
+void latency_reset() { memset(histogram,0,sizeof(histogram)); }
+
+
+uint32_t latency_now() { return(cycle_clock_cycles() - paused_cycles); }
+
+
+void latency_record(uint8_t stage, uint32_t start)
+{
+  uint32_t usec = (latency_now()-start)/(F_CPU/1000000);
+  latency_histogram_t *h = &histogram[stage];
+  if (usec > h->max_usec) { h->max_usec = usec; }
+  uint8_t bin = 0;
+  usec /= LATENCY_BIN_0_USEC;
+  while (usec && (bin < LATENCY_N_BIN-1)) {
+    usec >>= 1;
+    bin++;
+  }
+  if (h->count[bin] < 0xFFFFFFFF) { h->count[bin]++; }
+}
+
+
+// NOTE: Not nested. An abort during a pause simply leaves it unterminated, which is harmless.
+void latency_pause() { pause_start = cycle_clock_cycles(); }
+
+
+void latency_resume() { paused_cycles += cycle_clock_cycles() - pause_start; }
+
+
+latency_histogram_t *latency_get_histogram(uint8_t stage) { return(&histogram[stage]); }
+
+#endif
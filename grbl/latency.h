@@ -0,0 +1,62 @@
+/*
+  latency.h - Main loop latency profiling header file
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef latency_h
+#define latency_h
+
+#include "grbl.h"
+
+// Main program stages profiled by the latency histograms.
+#define LATENCY_LOOP   0 // One protocol_main_loop() iteration or executed line, whichever ends first
+#define LATENCY_PARSE  1 // gc_execute_line(), planning included
+#define LATENCY_PLAN   2 // plan_buffer_line()
+#define LATENCY_PREP   3 // st_prep_buffer()
+#define LATENCY_REPORT 4 // report_realtime_status()
+#define LATENCY_N_STAGE 5
+
+// Histogram bins. Bin 0 counts times below 32usec and each following bin doubles the limit. The
+// last bin counts everything from 8.192msec up.
+#define LATENCY_N_BIN 10
+#define LATENCY_BIN_0_USEC 32
+
+typedef struct {
+  uint32_t count[LATENCY_N_BIN];
+  uint32_t max_usec;
+} latency_histogram_t;
+
+// Clears the histograms. The profiling clock is started by cycle_clock_init().
+void latency_init();
+
+// Clears the histograms.
+void latency_reset();
+
+// Returns the profiling clock in CPU cycles. Time spent waiting for the stepper is excluded.
+uint32_t latency_now();
+
+// Adds the time elapsed since start, a latency_now() value, to the histogram of a stage.
+void latency_record(uint8_t stage, uint32_t start);
+
+// Stops and restarts the profiling clock around waits for the stepper to make progress, like a
+// full planner buffer or a buffer synchronization. Such waits are not main program work.
+void latency_pause();
+void latency_resume();
+
+// Returns the histogram of a stage.
+latency_histogram_t *latency_get_histogram(uint8_t stage);
+
+#endif
@@ -273,6 +273,14 @@ void limits_go_home(uint8_t cycle_mask)
       max_travel = max(max_travel,(-HOMING_AXIS_SEARCH_SCALAR)*settings.max_travel[idx]);
     }
   }
+  #ifdef PLAN_MAX_BLOCK_STEPS
+    // The search motion is a single planner block. Keep it within the block step count.
+    for (idx=0; idx<N_AXIS; idx++) {
+      if (bit_istrue(cycle_mask,bit(idx))) {
+        max_travel = min(max_travel,(PLAN_MAX_BLOCK_STEPS-1)*settings_derived.mm_per_step[idx]);
+      }
+    }
+  #endif
   // Set search mode with approach at seek rate to quickly engage the specified cycle_mask limit switches.
   bool approach = true;
   float homing_rate = settings.homing_seek_rate;
@@ -39,10 +39,16 @@ volatile uint8_t sys_rt_exec_accessory_override; // Global realtime executor bit
 int main(void)
 {
   // Initialize system upon power-up.
+  #if defined(ENABLE_MAIN_LOOP_PROFILE) || defined(ENABLE_EVENT_TRACE) || defined(ENABLE_BLOCK_TIMING)
+    cycle_clock_init(); // Start profiling and event trace clock first, to timestamp any settings restore
+  #endif
   serial_init();   // Setup serial baud rate and interrupts
   settings_init(); // Load Grbl settings from EEPROM
   stepper_init();  // Configure stepper pins and interrupt timers
   system_init();   // Configure pinout pins and pin-change interrupt
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_init(); // Clear main loop latency histograms
+  #endif
 
   memset(sys_position,0,sizeof(sys_position)); // Clear machine position.
   sei(); // Enable interrupts
@@ -22,6 +22,41 @@
 #include "grbl.h"
 
 
+#ifdef PATH_BLENDING
+// Rounds the corner between the last line motion and a new one to target, where the planner finds
+// a blend arc within the path tolerance. The arc is traced in line segments with their end points on
+// the arc, like mc_arc(), and the new line then starts at the arc end.
+static void mc_blend_corner(float *target, plan_line_data_t *pl_data)
+{
+  plan_blend_t blend;
+  if (!plan_blend_corner(target, pl_data, &blend)) { return; }
+
+  uint16_t segments = 1;
+  if (2*blend.radius > settings.arc_tolerance) {
+    segments = max(1, floor(0.5*blend.angle*blend.radius/
+                            sqrt(settings.arc_tolerance*(2*blend.radius - settings.arc_tolerance))));
+  }
+  plan_line_data_t arc_data;
+  memcpy(&arc_data, pl_data, sizeof(plan_line_data_t));
+  arc_data.path_tolerance = 0.0; // The arc segments are not blended themselves.
+
+  float position[N_AXIS];
+  uint16_t i;
+  uint8_t idx;
+  for (i = 1; i<=segments; i++) {
+    float angle = (blend.angle*i)/segments;
+    float along = blend.radius*sin(angle);
+    float across = blend.radius*(1.0-cos(angle));
+    for (idx=0; idx<N_AXIS; idx++) {
+      position[idx] = blend.start[idx] + along*blend.tangent[idx] + across*blend.normal[idx];
+    }
+    mc_line(position, &arc_data);
+    if (sys.abort) { return; }
+  }
+}
+#endif
+
+
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
 // (1 minute)/feed_rate time.
@@ -41,6 +76,40 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
   if (sys.state == STATE_CHECK_MODE) { return; }
 
+  #ifdef PATH_BLENDING
+    // Under G64, round the corner with the last line motion before planning this one.
+    if (pl_data->path_tolerance > 0.0) {
+      mc_blend_corner(target, pl_data);
+      if (sys.abort) { return; }
+    }
+  #endif
+
+  #ifdef PLAN_MAX_BLOCK_STEPS
+    // Split a line motion with more steps than a planner block holds into equal parts.
+    float position[N_AXIS];
+    uint16_t parts = plan_compute_line_parts(target, position);
+    if (parts > 1) {
+      plan_line_data_t part_data;
+      memcpy(&part_data, pl_data, sizeof(plan_line_data_t));
+      #ifdef PATH_BLENDING
+        part_data.path_tolerance = 0.0; // The corner before the first part is already blended.
+      #endif
+      if (part_data.condition & PL_COND_FLAG_INVERSE_TIME) { part_data.feed_rate *= parts; }
+      float part_target[N_AXIS];
+      uint16_t i;
+      uint8_t idx;
+      for (i = 1; i<=parts; i++) {
+        for (idx=0; idx<N_AXIS; idx++) {
+          if (i == parts) { part_target[idx] = target[idx]; }
+          else { part_target[idx] = position[idx] + ((target[idx]-position[idx])*i)/parts; }
+        }
+        mc_line(part_target, &part_data);
+        if (sys.abort) { return; }
+      }
+      return;
+    }
+  #endif
+
   // NOTE: Backlash compensation may be installed here. It will need direction info to track when
   // to insert a backlash line motion(s) before the intended line motion and will require its own
   // plan_check_full_buffer() and check for system abort loop. Also for position reporting
@@ -57,15 +126,28 @@ void mc_line(float *target, plan_line_data_t *pl_data)
 
   // If the buffer is full: good! That means we are well ahead of the robot.
   // Remain in this loop until there is room in the buffer.
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_pause();
+  #endif
   do {
     protocol_execute_realtime(); // Check for any run-time commands
     if (sys.abort) { return; } // Bail, if system abort.
     if ( plan_check_full_buffer() ) { protocol_auto_cycle_start(); } // Auto-cycle start when buffer is full.
     else { break; }
   } while (1);
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_resume();
+  #endif
 
   // Plan and queue motion into planner buffer
-  if (plan_buffer_line(target, pl_data) == PLAN_EMPTY_BLOCK) {
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    uint32_t plan_start = latency_now();
+  #endif
+  uint8_t plan_status = plan_buffer_line(target, pl_data);
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_record(LATENCY_PLAN,plan_start);
+  #endif
+  if (plan_status == PLAN_EMPTY_BLOCK) {
     if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) {
       // Correctly set spindle state, if there is a coincident position passed. Forces a buffer
       // sync while in M3 laser mode only.
@@ -196,7 +278,13 @@ void mc_dwell(float seconds)
 {
   if (sys.state == STATE_CHECK_MODE) { return; }
   protocol_buffer_synchronize();
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_pause();
+  #endif
   delay_sec(seconds, DELAY_MODE_DWELL);
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_resume();
+  #endif
 }
 
 
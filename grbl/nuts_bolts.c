@@ -177,14 +177,15 @@ float convert_delta_vector_to_unit_vector(float *vector)
 }
 
 
-float limit_value_by_axis_maximum(float *max_value, float *unit_vec)
+float limit_value_by_axis_maximum(float *inv_max_value, float *unit_vec)
 {
   uint8_t idx;
-  float limit_value = SOME_LARGE_VALUE;
+  float inv_limit_value = 0.0;
   for (idx=0; idx<N_AXIS; idx++) {
-    if (unit_vec[idx] != 0) {  // Avoid divide by zero.
-      limit_value = min(limit_value,fabs(max_value[idx]/unit_vec[idx]));
+    if (unit_vec[idx] != 0) {  // Avoid 0*inf for axes with a zero maximum.
+      inv_limit_value = max(inv_limit_value,fabs(unit_vec[idx]*inv_max_value[idx]));
     }
   }
-  return(limit_value);
+  if (inv_limit_value == 0.0) { return(SOME_LARGE_VALUE); }
+  return(1.0/inv_limit_value);
 }
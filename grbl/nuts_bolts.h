@@ -82,6 +82,6 @@ void delay_us(uint32_t us);
 float hypot_f(float x, float y);
 
 float convert_delta_vector_to_unit_vector(float *vector);
-float limit_value_by_axis_maximum(float *max_value, float *unit_vec);
+float limit_value_by_axis_maximum(float *inv_max_value, float *unit_vec);
 
 #endif
@@ -24,10 +24,13 @@
 
 
 static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
-static uint8_t block_buffer_tail;     // Index of the block to process now
-static uint8_t block_buffer_head;     // Index of the next block to be pushed
-static uint8_t next_buffer_head;      // Index of the next buffer head
-static uint8_t block_buffer_planned;  // Index of the optimally planned block
+static plan_index_t block_buffer_tail;    // Index of the block to process now
+static plan_index_t block_buffer_head;    // Index of the next block to be pushed
+static plan_index_t next_buffer_head;     // Index of the next buffer head
+static plan_index_t block_buffer_planned; // Index of the optimally planned block
+#ifdef PLANNER_RECALCULATE_LIMIT
+  static plan_index_t block_buffer_resume; // Index of the block an unfinished reverse pass resumes from
+#endif
 
 // Define planner variables
 typedef struct {
@@ -36,12 +39,29 @@ typedef struct {
                                      // i.e. arcs, canned cycles, and backlash compensation.
   float previous_unit_vec[N_AXIS];   // Unit vector of previous path line segment
   float previous_nominal_speed;  // Nominal speed of previous path line segment
+  #ifdef PLANNER_COALESCE_TOLERANCE
+    uint8_t coalesce_ready;          // True, if the next line motion may be merged into the last block.
+    float coalesce_delta[N_AXIS];    // Distance from the start to the end of the last block per axis (mm)
+    float coalesce_error;            // Summed deviation of the junctions merged into the last block (mm)
+    float coalesce_feed_rate;        // Programmed feed rate of the last block
+  #endif
+  #ifdef PLANNER_CURVATURE_WINDOW
+    float curve_point[PLANNER_CURVATURE_WINDOW][N_AXIS]; // Programmed end points of the last blocks (mm). Ring buffer.
+    uint8_t curve_index;             // Ring index of the oldest end point, overwritten by the next one
+    uint8_t curve_count;             // Number of blocks since the path last started from rest
+  #endif
+  #ifdef PLANNER_LAZY_OVERRIDES
+    uint8_t override_epoch;          // Counts override changes. See plan_update_block_profile().
+  #endif
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    float buffer_time;               // Execution time of the blocks queued after the buffer tail (ms)
+  #endif
 } planner_t;
 static planner_t pl;
 
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
-uint8_t plan_next_block_index(uint8_t block_index)
+plan_index_t plan_next_block_index(plan_index_t block_index)
 {
   block_index++;
   if (block_index == BLOCK_BUFFER_SIZE) { block_index = 0; }
@@ -50,7 +70,7 @@ uint8_t plan_next_block_index(uint8_t block_index)
 
 
 // Returns the index of the previous block in the ring buffer
-static uint8_t plan_prev_block_index(uint8_t block_index)
+static plan_index_t plan_prev_block_index(plan_index_t block_index)
 {
   if (block_index == 0) { block_index = BLOCK_BUFFER_SIZE; }
   block_index--;
@@ -58,6 +78,95 @@ static uint8_t plan_prev_block_index(uint8_t block_index)
 }
 
 
+#ifdef COMPACT_PLANNER_BLOCK
+  static void plan_pack_uint24(plan_uint24_t *packed, uint32_t value)
+  {
+    packed->byte[0] = value;
+    packed->byte[1] = value >> 8;
+    packed->byte[2] = value >> 16;
+  }
+
+
+  uint32_t plan_unpack_uint24(const plan_uint24_t *packed)
+  {
+    return(packed->byte[0] | ((uint16_t)packed->byte[1] << 8) | ((uint32_t)packed->byte[2] << 16));
+  }
+
+
+  // Speeds are stored with 8 fractional bits. Larger values are saturated.
+  static void plan_pack_speed(plan_uint24_t *packed, float speed)
+  {
+    if (speed >= 65535.0) { plan_pack_uint24(packed, 0xFFFFFF); }
+    else { plan_pack_uint24(packed, lround(speed*256.0)); }
+  }
+
+
+  float plan_unpack_speed(const plan_uint24_t *packed) { return(plan_unpack_uint24(packed)*(1.0/256.0)); }
+
+
+  uint32_t plan_get_step_event_count(plan_block_t *block)
+  {
+    uint32_t step_event_count = 0;
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) { step_event_count = max(step_event_count, plan_unpack_uint24(&block->steps[idx])); }
+    return(step_event_count);
+  }
+#endif
+
+
+#ifdef S_CURVE_ACCELERATION
+/* Jerk-limited ramps. Each acceleration or deceleration ramp within a block starts and ends at zero
+   acceleration. Over a speed change dv, the acceleration rises at the block jerk j to at most the
+   block acceleration a, holds, and falls back to zero. When dv < a^2/j, it peaks below a. The ramp
+   takes the time T = dv/a + a/j, or 2*sqrt(dv/j) when it peaks below a. Its velocity is symmetric
+   about the middle, so it covers (v0+v1)/2*T, just like a constant acceleration ramp of that time.
+   Splitting a ramp takes longer than a single one, so the planner plans with the same ramps that
+   the segment generator executes: one per block and direction, joined at zero acceleration.
+*/
+// Returns the distance (mm) of a jerk-limited ramp between two speeds (mm/min) in the given block.
+float plan_compute_ramp_distance(plan_block_t *block, float speed, float target_speed)
+{
+  float delta_speed = fabs(target_speed-speed);
+  float ramp_time;
+  if (delta_speed*block->jerk < block->acceleration*block->acceleration) {
+    ramp_time = 2.0*sqrt(delta_speed/block->jerk);
+  } else {
+    ramp_time = delta_speed/block->acceleration + block->acceleration/block->jerk;
+  }
+  return(0.5*(speed+target_speed)*ramp_time);
+}
+
+
+// Returns the highest speed (sqr) reachable from, or able to reach, the given speed (sqr) with a
+// single ramp over the full block length. Replaces v^2 = v0^2 + 2*a*d of constant acceleration.
+static float plan_compute_ramp_speed_sqr(plan_block_t *block, float speed_sqr)
+{
+  float speed = sqrt(speed_sqr);
+  float jerk_speed = block->acceleration*block->acceleration/block->jerk; // dv at which the ramp reaches a
+  if (block->millimeters*block->jerk >= (2*speed+jerk_speed)*block->acceleration) {
+    // Reaches full acceleration. Solve (v+v1)*(v1-v+a^2/j) = 2*a*d for the new speed v1.
+    float rhs = speed_sqr + 2*block->acceleration*block->millimeters - jerk_speed*speed;
+    speed = 0.5*(sqrt(jerk_speed*jerk_speed + 4*rhs) - jerk_speed);
+    return(speed*speed);
+  }
+  // Peaks below full acceleration. With s = sqrt(dv), solve s^3 + 2*v*s = d*sqrt(j) by Newton's
+  // method. The start is an upper bound of the root and the iterations approach it from above.
+  float q = block->millimeters*sqrt(block->jerk);
+  float s;
+  if (q*q < 8*speed_sqr*speed) { s = q/(2*speed); }
+  else { s = cbrt(q); }
+  if (speed > 0.0) { // Otherwise exact.
+    uint8_t i;
+    for (i=0; i<3; i++) { s -= (s*s*s + 2*speed*s - q)/(3*s*s + 2*speed); }
+  }
+  speed += s*s;
+  return(speed*speed);
+}
+#else
+  #define plan_compute_ramp_speed_sqr(block,speed_sqr) ((speed_sqr) + 2*(block)->acceleration*(block)->millimeters)
+#endif
+
+
 /*                            PLANNER SPEED DEFINITION
                                      +--------+   <- current->nominal_speed
                                     /          \
@@ -123,10 +232,35 @@ static uint8_t plan_prev_block_index(uint8_t block_index)
   ARM versions should have enough memory and speed for look-ahead blocks numbering up to a hundred or more.
 
 */
-static void planner_recalculate()
+#ifdef PLANNER_LAZY_OVERRIDES
+// Brings the max entry speed of a block up to date with the current overrides. An override change
+// only counts up the override epoch, and each block is updated when the planner or the stepper next
+// reads its max entry speed, instead of all blocks at once. As in plan_compute_profile_parameters(),
+// the limit is the lower of the junction speed and both neighboring nominal speeds.
+static void plan_update_block_profile(plan_index_t block_index)
 {
-  // Initialize block index to the last block in the planner buffer.
-  uint8_t block_index = plan_prev_block_index(block_buffer_head);
+  plan_block_t *block = &block_buffer[block_index];
+  if (block->override_epoch == pl.override_epoch) { return; }
+  block->override_epoch = pl.override_epoch;
+  float nominal_speed = plan_compute_profile_nominal_speed(block);
+  if (block_index != block_buffer_tail) {
+    float prev_nominal_speed = plan_compute_profile_nominal_speed(&block_buffer[plan_prev_block_index(block_index)]);
+    if (prev_nominal_speed < nominal_speed) { nominal_speed = prev_nominal_speed; }
+  }
+  block->max_entry_speed_sqr = min(nominal_speed*nominal_speed, block->max_junction_speed_sqr);
+}
+#endif
+
+
+// Plans the blocks before end_index, which is the buffer head after a new block has been added.
+// NOTE: With PLANNER_RECALCULATE_LIMIT, the reverse pass stops after the limit. The blocks it did
+// not reach keep their entry speeds, which still decelerate to their old exit speeds and are safe.
+// The forward pass then only begins at the last block not reached, and the rest of the reverse pass
+// is resumed from block_buffer_resume by plan_resume_recalculation().
+static void planner_recalculate(plan_index_t end_index)
+{
+  // Initialize block index to the last block to be planned.
+  plan_index_t block_index = plan_prev_block_index(end_index);
 
   // Bail. Can't do anything with one only one plan-able block.
   if (block_index == block_buffer_planned) { return; }
@@ -137,18 +271,40 @@ static void planner_recalculate()
   float entry_speed_sqr;
   plan_block_t *next;
   plan_block_t *current = &block_buffer[block_index];
+  plan_index_t planned_index = block_buffer_planned;
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    block_buffer_resume = block_buffer_planned; // A complete reverse pass leaves nothing to resume.
+  #endif
 
   // Calculate maximum entry speed for last block in buffer, where the exit speed is always zero.
-  current->entry_speed_sqr = min( current->max_entry_speed_sqr, 2*current->acceleration*current->millimeters);
+  if (end_index == block_buffer_head) {
+    #ifdef PLANNER_LAZY_OVERRIDES
+      plan_update_block_profile(block_index);
+    #endif
+    current->entry_speed_sqr = min( current->max_entry_speed_sqr, plan_compute_ramp_speed_sqr(current, 0.0));
+  }
 
   block_index = plan_prev_block_index(block_index);
   if (block_index == block_buffer_planned) { // Only two plannable blocks in buffer. Reverse pass complete.
     // Check if the first block is the tail. If so, notify stepper to update its current parameters.
     if (block_index == block_buffer_tail) { st_update_plan_block_parameters(); }
   } else { // Three or more plan-able blocks
+    #ifdef PLANNER_RECALCULATE_LIMIT
+      plan_index_t limit = PLANNER_RECALCULATE_LIMIT;
+    #endif
     while (block_index != block_buffer_planned) {
+      #ifdef PLANNER_RECALCULATE_LIMIT
+        if (limit-- == 0) { // Out of budget. Resume from the last block planned.
+          block_buffer_resume = plan_next_block_index(block_index);
+          planned_index = block_index;
+          break;
+        }
+      #endif
       next = current;
       current = &block_buffer[block_index];
+      #ifdef PLANNER_LAZY_OVERRIDES
+        plan_update_block_profile(block_index);
+      #endif
       block_index = plan_prev_block_index(block_index);
 
       // Check if next block is the tail block(=planned block). If so, update current stepper parameters.
@@ -156,7 +312,7 @@ static void planner_recalculate()
 
       // Compute maximum entry speed decelerating over the current block from its exit speed.
       if (current->entry_speed_sqr != current->max_entry_speed_sqr) {
-        entry_speed_sqr = next->entry_speed_sqr + 2*current->acceleration*current->millimeters;
+        entry_speed_sqr = plan_compute_ramp_speed_sqr(current, next->entry_speed_sqr);
         if (entry_speed_sqr < current->max_entry_speed_sqr) {
           current->entry_speed_sqr = entry_speed_sqr;
         } else {
@@ -168,9 +324,9 @@ static void planner_recalculate()
 
   // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
   // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
-  next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
-  block_index = plan_next_block_index(block_buffer_planned);
-  while (block_index != block_buffer_head) {
+  next = &block_buffer[planned_index]; // Begin at buffer planned pointer
+  block_index = plan_next_block_index(planned_index);
+  while (block_index != end_index) {
     current = next;
     next = &block_buffer[block_index];
 
@@ -178,11 +334,11 @@ static void planner_recalculate()
     // pointer forward, since everything before this is all optimal. In other words, nothing
     // can improve the plan from the buffer tail to the planned pointer by logic.
     if (current->entry_speed_sqr < next->entry_speed_sqr) {
-      entry_speed_sqr = current->entry_speed_sqr + 2*current->acceleration*current->millimeters;
+      entry_speed_sqr = plan_compute_ramp_speed_sqr(current, current->entry_speed_sqr);
       // If true, current block is full-acceleration and we can move the planned pointer forward.
       if (entry_speed_sqr < next->entry_speed_sqr) {
         next->entry_speed_sqr = entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
-        block_buffer_planned = block_index; // Set optimal plan pointer.
+        planned_index = block_index; // Set optimal plan pointer.
       }
     }
 
@@ -190,10 +346,40 @@ static void planner_recalculate()
     // point in the buffer. When the plan is bracketed by either the beginning of the
     // buffer and a maximum entry speed or two maximum entry speeds, every block in between
     // cannot logically be further improved. Hence, we don't have to recompute them anymore.
-    if (next->entry_speed_sqr == next->max_entry_speed_sqr) { block_buffer_planned = block_index; }
+    if (next->entry_speed_sqr == next->max_entry_speed_sqr) { planned_index = block_index; }
     block_index = plan_next_block_index( block_index );
   }
+
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    // A resumed pass may have lowered the entry speed of its last block, e.g. after a feed hold.
+    // Carry this on to the following blocks for as long as their entry speeds can't be reached.
+    while (block_index != block_buffer_head) {
+      current = next;
+      next = &block_buffer[block_index];
+      entry_speed_sqr = plan_compute_ramp_speed_sqr(current, current->entry_speed_sqr);
+      if (entry_speed_sqr >= next->entry_speed_sqr) { break; }
+      next->entry_speed_sqr = entry_speed_sqr;
+      planned_index = block_index;
+      block_index = plan_next_block_index( block_index );
+    }
+
+    // Blocks behind an unfinished reverse pass are not optimal yet. Keep the planned pointer.
+    if (block_buffer_resume != block_buffer_planned) { return; }
+    block_buffer_resume = planned_index;
+  #endif
+  block_buffer_planned = planned_index;
+}
+
+
+#ifdef PLANNER_RECALCULATE_LIMIT
+// Continues a reverse pass that planner_recalculate() cut short, for up to another
+// PLANNER_RECALCULATE_LIMIT blocks, and forward plans the blocks it changed.
+void plan_resume_recalculation()
+{
+  if (block_buffer_resume == block_buffer_planned) { return; } // Nothing left to plan.
+  planner_recalculate(plan_next_block_index(block_buffer_resume));
 }
+#endif
 
 
 void plan_reset()
@@ -209,16 +395,33 @@ void plan_reset_buffer()
   block_buffer_head = 0; // Empty = tail
   next_buffer_head = 1; // plan_next_block_index(block_buffer_head)
   block_buffer_planned = 0; // = block_buffer_tail;
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    block_buffer_resume = 0;
+  #endif
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    pl.buffer_time = 0.0;
+  #endif
 }
 
 
 void plan_discard_current_block()
 {
   if (block_buffer_head != block_buffer_tail) { // Discard non-empty buffer.
-    uint8_t block_index = plan_next_block_index( block_buffer_tail );
+    plan_index_t block_index = plan_next_block_index( block_buffer_tail );
+    #ifdef ENABLE_EVENT_TRACE
+      event_trace_record(EVENT_BLOCK_DISCARD, 0, plan_block_line_number(&block_buffer[block_buffer_tail]));
+    #endif
     // Push block_buffer_planned pointer, if encountered.
     if (block_buffer_tail == block_buffer_planned) { block_buffer_planned = block_index; }
+    #ifdef PLANNER_RECALCULATE_LIMIT
+      if (block_buffer_tail == block_buffer_resume) { block_buffer_resume = block_index; }
+    #endif
     block_buffer_tail = block_index;
+    #ifdef REPORT_FIELD_BUFFER_TIME
+      // The new tail is counted by plan_get_buffer_time() from its remaining distance instead.
+      if (block_buffer_head == block_buffer_tail) { pl.buffer_time = 0.0; } // Clear rounding errors.
+      else { pl.buffer_time -= block_buffer[block_index].millimeters*block_buffer[block_index].time_per_mm; }
+    #endif
   }
 }
 
@@ -240,8 +443,15 @@ plan_block_t *plan_get_current_block()
 
 float plan_get_exec_block_exit_speed_sqr()
 {
-  uint8_t block_index = plan_next_block_index(block_buffer_tail);
+  plan_index_t block_index = plan_next_block_index(block_buffer_tail);
   if (block_index == block_buffer_head) { return( 0.0 ); }
+  #ifdef PLANNER_LAZY_OVERRIDES
+    // The planner may not have reached this block since an override change. Never exit faster than
+    // the block may now be entered.
+    plan_update_block_profile(block_index);
+    plan_block_t *block = &block_buffer[block_index];
+    if (block->entry_speed_sqr > block->max_entry_speed_sqr) { block->entry_speed_sqr = block->max_entry_speed_sqr; }
+  #endif
   return( block_buffer[block_index].entry_speed_sqr );
 }
 
@@ -258,11 +468,12 @@ uint8_t plan_check_full_buffer()
 // NOTE: All system motion commands, such as homing/parking, are not subject to overrides.
 float plan_compute_profile_nominal_speed(plan_block_t *block)
 {
-  float nominal_speed = block->programmed_rate;
+  float nominal_speed = plan_block_programmed_rate(block);
   if (block->condition & PL_COND_FLAG_RAPID_MOTION) { nominal_speed *= (0.01*sys.r_override); }
   else {
     if (!(block->condition & PL_COND_FLAG_NO_FEED_OVERRIDE)) { nominal_speed *= (0.01*sys.f_override); }
-    if (nominal_speed > block->rapid_rate) { nominal_speed = block->rapid_rate; }
+    float rapid_rate = plan_block_rapid_rate(block);
+    if (nominal_speed > rapid_rate) { nominal_speed = rapid_rate; }
   }
   if (nominal_speed > MINIMUM_FEED_RATE) { return(nominal_speed); }
   return(MINIMUM_FEED_RATE);
@@ -281,9 +492,39 @@ static void plan_compute_profile_parameters(plan_block_t *block, float nominal_s
 
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
+#ifdef PLANNER_LAZY_OVERRIDES
+// Only the last block is updated here, for the next incoming block. The others are updated as the
+// re-plan started here reaches them. With PLANNER_RECALCULATE_LIMIT, the re-plan is spread out over
+// the main loop like any other. Until then, the stepper slows down to any lower nominal speed itself.
+void plan_update_velocity_profile_parameters()
+{
+  if (++pl.override_epoch == 0) {
+    // All epochs have been used. Blocks last updated 256 changes ago would look up to date.
+    plan_index_t block_index;
+    for (block_index = block_buffer_tail; block_index != block_buffer_head; block_index = plan_next_block_index(block_index)) {
+      block_buffer[block_index].override_epoch = 1;
+    }
+    pl.override_epoch = 2;
+  }
+  pl.previous_nominal_speed = SOME_LARGE_VALUE;
+  if (block_buffer_head != block_buffer_tail) {
+    plan_index_t block_index = plan_prev_block_index(block_buffer_head);
+    plan_update_block_profile(block_index);
+    pl.previous_nominal_speed = plan_compute_profile_nominal_speed(&block_buffer[block_index]);
+  }
+
+  // Re-plan from the buffer tail, as plan_cycle_reinitialize() does, but without finishing a bounded re-plan now.
+  st_update_plan_block_parameters();
+  block_buffer_planned = block_buffer_tail;
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    block_buffer_resume = block_buffer_tail;
+  #endif
+  planner_recalculate(block_buffer_head);
+}
+#else
 void plan_update_velocity_profile_parameters()
 {
-  uint8_t block_index = block_buffer_tail;
+  plan_index_t block_index = block_buffer_tail;
   plan_block_t *block;
   float nominal_speed;
   float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
@@ -296,6 +537,256 @@ void plan_update_velocity_profile_parameters()
   }
   pl.previous_nominal_speed = prev_nominal_speed; // Update prev nominal speed for next incoming block.
 }
+#endif
+
+
+#ifdef PLANNER_COALESCE_TOLERANCE
+// Merges a new line motion into the last block in the buffer, instead of queueing it as a block of
+// its own. Both must share the motion conditions, feed rate, spindle speed and step directions, and
+// the junction between them must lie within PLANNER_COALESCE_TOLERANCE of the merged line. The
+// deviations of all junctions merged into a block are summed, which bounds the distance of each of
+// them from the final line. The stepper may have loaded the buffer tail, so it is never merged into.
+// The merged block keeps its entry speed and junction limit. It is only merged, when its
+// deceleration distance and nominal speed do not drop below what the current plan relies on.
+// Returns true, if the motion was merged.
+static uint8_t plan_coalesce_line(plan_block_t *new_block, uint32_t *steps, float *delta_mm,
+                                  int32_t *target_steps, float feed_rate)
+{
+  if (!pl.coalesce_ready || (block_buffer_head == block_buffer_tail)) { return(false); }
+  plan_index_t block_index = plan_prev_block_index(block_buffer_head);
+  if (block_index == block_buffer_tail) { return(false); }
+  plan_block_t *block = &block_buffer[block_index];
+
+  if (new_block->condition != block->condition) { return(false); }
+  if (!(block->condition & PL_COND_FLAG_RAPID_MOTION) && (feed_rate != pl.coalesce_feed_rate)) { return(false); }
+  if (plan_block_spindle_speed(new_block) != plan_block_spindle_speed(block)) { return(false); }
+  #ifdef DEFAULTS_RAMPS_BOARD
+    if (memcmp(new_block->direction_bits, block->direction_bits, sizeof(block->direction_bits))) { return(false); }
+  #else
+    if (new_block->direction_bits != block->direction_bits) { return(false); }
+  #endif
+
+  // Distance of the junction from the merged line, |D x d|/|D+d|. The squared cross product is
+  // summed over all pairs of axes (Lagrange identity), so this works for any number of axes.
+  float unit_vec[N_AXIS];
+  float cross_sqr = 0.0;
+  uint8_t idx, jdx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    unit_vec[idx] = pl.coalesce_delta[idx]+delta_mm[idx]; // Store unit vector numerator
+    for (jdx=idx+1; jdx<N_AXIS; jdx++) {
+      float cross = pl.coalesce_delta[idx]*delta_mm[jdx] - pl.coalesce_delta[jdx]*delta_mm[idx];
+      cross_sqr += cross*cross;
+    }
+  }
+  float millimeters = convert_delta_vector_to_unit_vector(unit_vec);
+  float error = pl.coalesce_error + sqrt(cross_sqr)/millimeters;
+  if (error > PLANNER_COALESCE_TOLERANCE) { return(false); }
+
+  plan_block_t merged;
+  memcpy(&merged, block, sizeof(plan_block_t));
+  merged.millimeters = millimeters;
+  merged.acceleration = limit_value_by_axis_maximum(settings_derived.inv_acceleration, unit_vec);
+  // The current plan relies on the ramps of the old block. They must not take longer.
+  #ifdef S_CURVE_ACCELERATION
+    merged.jerk = limit_value_by_axis_maximum(settings_derived.inv_jerk, unit_vec);
+    if ((merged.acceleration < block->acceleration) || (merged.jerk < block->jerk)) { return(false); }
+  #else // Deceleration distance 2*a*d
+    if (merged.acceleration*millimeters < block->acceleration*block->millimeters) { return(false); }
+  #endif
+
+  uint32_t step_event_count = 0;
+  for (idx=0; idx<N_AXIS; idx++) {
+    steps[idx] += plan_block_steps(block,idx);
+    step_event_count = max(step_event_count, steps[idx]);
+  }
+  float rapid_rate = limit_value_by_axis_maximum(settings_derived.inv_max_rate, unit_vec);
+  #ifdef PLAN_MAX_BLOCK_STEPS
+    if (step_event_count > PLAN_MAX_BLOCK_STEPS) { return(false); }
+  #endif
+  #ifdef COMPACT_PLANNER_BLOCK
+    for (idx=0; idx<N_AXIS; idx++) { plan_pack_uint24(&merged.steps[idx], steps[idx]); }
+    plan_pack_speed(&merged.rapid_rate, rapid_rate);
+    if (block->condition & PL_COND_FLAG_RAPID_MOTION) { plan_pack_speed(&merged.programmed_rate, rapid_rate); }
+  #else
+    memcpy(merged.steps, steps, sizeof(merged.steps));
+    merged.step_event_count = step_event_count;
+    merged.rapid_rate = rapid_rate;
+    if (block->condition & PL_COND_FLAG_RAPID_MOTION) { merged.programmed_rate = rapid_rate; }
+  #endif
+  float nominal_speed = plan_compute_profile_nominal_speed(&merged);
+  if (nominal_speed*nominal_speed < block->max_entry_speed_sqr) { return(false); }
+
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    merged.time_per_mm = 60000.0/nominal_speed;
+    pl.buffer_time += merged.millimeters*merged.time_per_mm - block->millimeters*block->time_per_mm;
+  #endif
+  memcpy(block, &merged, sizeof(plan_block_t));
+  pl.previous_nominal_speed = nominal_speed;
+  memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec));
+  memcpy(pl.position, target_steps, sizeof(pl.position));
+  for (idx=0; idx<N_AXIS; idx++) { pl.coalesce_delta[idx] += delta_mm[idx]; }
+  pl.coalesce_error = error;
+
+  // The longer block may now reach a higher exit speed.
+  planner_recalculate(block_buffer_head);
+  return(true);
+}
+#endif
+
+
+#ifdef PATH_BLENDING
+// Rounds the corner between the last block in the buffer and a new line motion to target with an
+// arc that is tangent to both lines and passes the corner at the path tolerance. The arc begins
+// and ends at the same distance from the corner. This distance is limited to half of the new line
+// and half of the last block, and to the part of the last block it can still stop in from its
+// planned entry speed, so the current plan stays valid. The stepper may have loaded the buffer
+// tail, so it is never shortened. The junction speed limit models the corner as an arc of the
+// same form with the junction deviation as its tolerance. The corner is only blended, when the
+// blend arc is the larger one, and the last block can't already take the corner at nominal speed.
+uint8_t plan_blend_corner(float *target, plan_line_data_t *pl_data, plan_blend_t *blend)
+{
+  if (block_buffer_head == block_buffer_tail) { return(false); }
+  plan_index_t block_index = plan_prev_block_index(block_buffer_head);
+  if (block_index == block_buffer_tail) { return(false); }
+  plan_block_t *block = &block_buffer[block_index];
+  if (block->condition != pl_data->condition) { return(false); }
+
+  // The corner is at the planner position. Half angle of the turn from the last block to the new line.
+  float unit_vec[N_AXIS];
+  float cos_theta = 0.0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    blend->start[idx] = pl.position[idx]*settings_derived.mm_per_step[idx];
+    unit_vec[idx] = target[idx]-blend->start[idx];
+  }
+  float millimeters = convert_delta_vector_to_unit_vector(unit_vec);
+  if (!(millimeters > 0.0)) { return(false); }
+  for (idx=0; idx<N_AXIS; idx++) { cos_theta += pl.previous_unit_vec[idx]*unit_vec[idx]; }
+  if ((cos_theta > 0.999999) || (cos_theta < -0.999999)) { return(false); } // Straight or reversing
+  float cos_theta_d2 = sqrt(0.5*(1.0+cos_theta)); // Trig half angle identities. Always positive.
+  float sin_theta_d2 = sqrt(0.5*(1.0-cos_theta));
+
+  // Distance from the corner to the arc ends. The arc radius is distance/tan(theta/2), and the
+  // arc passes the corner at radius*(1/cos(theta/2)-1).
+  float distance = pl_data->path_tolerance*(1.0+cos_theta_d2)/sin_theta_d2;
+  distance = min(distance, 0.5*millimeters);
+  distance = min(distance, 0.5*block->millimeters);
+  #ifdef S_CURVE_ACCELERATION
+    distance = min(distance, block->millimeters-plan_compute_ramp_distance(block, sqrt(block->entry_speed_sqr), 0.0));
+  #else
+    distance = min(distance, block->millimeters-block->entry_speed_sqr/(2.0*block->acceleration));
+  #endif
+  float junction_distance = settings.junction_deviation*(1.0+cos_theta_d2)/sin_theta_d2;
+  if (distance <= junction_distance) { return(false); }
+  if (block->acceleration*junction_distance*cos_theta_d2/sin_theta_d2 >=
+      pl.previous_nominal_speed*pl.previous_nominal_speed) { return(false); }
+
+  // Shorten the last block to end at the arc start. The block start follows from its end at the
+  // planner position and its step counts. Its direction, rates and entry speed don't change.
+  int32_t end_steps[N_AXIS];
+  uint32_t steps[N_AXIS], step_event_count = 0;
+  millimeters = 0.0;
+  for (idx=0; idx<N_AXIS; idx++) {
+    blend->start[idx] -= distance*pl.previous_unit_vec[idx];
+    end_steps[idx] = lround(blend->start[idx]*settings.steps_per_mm[idx]);
+    int32_t start_steps = pl.position[idx];
+    if (pl.previous_unit_vec[idx] < 0.0) { start_steps += plan_block_steps(block,idx); }
+    else { start_steps -= plan_block_steps(block,idx); }
+    steps[idx] = labs(end_steps[idx]-start_steps);
+    step_event_count = max(step_event_count, steps[idx]);
+    float delta_mm = (end_steps[idx]-start_steps)*settings_derived.mm_per_step[idx];
+    millimeters += delta_mm*delta_mm;
+  }
+  if (step_event_count == 0) { return(false); }
+  #ifdef PLAN_MAX_BLOCK_STEPS
+    if (step_event_count > PLAN_MAX_BLOCK_STEPS) { return(false); } // Rounded beyond the old block.
+  #endif
+  #ifdef COMPACT_PLANNER_BLOCK
+    for (idx=0; idx<N_AXIS; idx++) { plan_pack_uint24(&block->steps[idx], steps[idx]); }
+  #else
+    memcpy(block->steps, steps, sizeof(steps));
+    block->step_event_count = step_event_count;
+  #endif
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    pl.buffer_time += (sqrt(millimeters)-block->millimeters)*block->time_per_mm;
+  #endif
+  block->millimeters = sqrt(millimeters);
+  memcpy(pl.position, end_steps, sizeof(end_steps));
+  #ifdef PLANNER_COALESCE_TOLERANCE
+    pl.coalesce_ready = false; // The last block no longer spans the merged motions.
+  #endif
+
+  // The arc turns in the plane of both lines, toward the component of the new line normal to the last.
+  float sin_theta = 2.0*sin_theta_d2*cos_theta_d2;
+  for (idx=0; idx<N_AXIS; idx++) {
+    blend->tangent[idx] = pl.previous_unit_vec[idx];
+    blend->normal[idx] = (unit_vec[idx]-cos_theta*pl.previous_unit_vec[idx])/sin_theta;
+  }
+  blend->radius = distance*cos_theta_d2/sin_theta_d2;
+  blend->angle = 2.0*atan2(sin_theta_d2, cos_theta_d2);
+  return(true);
+}
+#endif
+
+
+#ifdef PLANNER_CURVATURE_WINDOW
+// Returns the junction speed limit of a new line to target from the curvature of the path over the
+// last PLANNER_CURVATURE_WINDOW blocks, such that the centripetal acceleration v^2/r stays within the
+// axis limits. The radius is that of the circle through the end points at the start, the middle and
+// the end of the window. This follows curves made of many short lines, where each junction angle
+// alone understates how sharply the path bends, and evens out the zig-zag noise of CAM output. The
+// programmed end points are used, since directions rounded to whole steps are too coarse for short
+// lines. Until the window is filled after a start from rest, there is no limit.
+static float plan_compute_curve_speed_sqr(float *target)
+{
+  if (pl.curve_count < PLANNER_CURVATURE_WINDOW) { return(SOME_LARGE_VALUE); }
+  uint8_t middle = pl.curve_index+PLANNER_CURVATURE_WINDOW/2;
+  if (middle >= PLANNER_CURVATURE_WINDOW) { middle -= PLANNER_CURVATURE_WINDOW; }
+  float *start = pl.curve_point[pl.curve_index];
+  float a[N_AXIS], b[N_AXIS];
+  float a_sqr = 0.0, b_sqr = 0.0, a_dot_b = 0.0, c_sqr = 0.0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    a[idx] = pl.curve_point[middle][idx]-start[idx];
+    b[idx] = target[idx]-pl.curve_point[middle][idx];
+    a_sqr += a[idx]*a[idx];
+    b_sqr += b[idx]*b[idx];
+    a_dot_b += a[idx]*b[idx];
+    c_sqr += (a[idx]+b[idx])*(a[idx]+b[idx]);
+  }
+  // Circumradius |a||b||a+b|/(2|a x b|), with |a x b|^2 = |a|^2*|b|^2-(a.b)^2 for any number of axes.
+  float cross_sqr = a_sqr*b_sqr-a_dot_b*a_dot_b;
+  if (!(cross_sqr > 0.0)) { return(SOME_LARGE_VALUE); } // Straight
+  float radius = 0.5*sqrt(a_sqr*b_sqr*c_sqr/cross_sqr);
+  // The centripetal acceleration is along the line from the middle point to the chord of the others.
+  for (idx=0; idx<N_AXIS; idx++) { a[idx] -= b[idx]; }
+  convert_delta_vector_to_unit_vector(a);
+  return(limit_value_by_axis_maximum(settings_derived.inv_acceleration, a)*radius);
+}
+#endif
+
+
+#ifdef PLAN_MAX_BLOCK_STEPS
+uint16_t plan_compute_line_parts(float *target, float *position)
+{
+  int32_t delta_steps[N_AXIS];
+  uint32_t step_event_count = 0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    delta_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]) - pl.position[idx];
+    position[idx] = pl.position[idx]*settings_derived.mm_per_step[idx];
+  }
+  #ifdef COREXY
+    step_event_count = max(labs(delta_steps[X_AXIS]+delta_steps[Y_AXIS]), labs(delta_steps[X_AXIS]-delta_steps[Y_AXIS]));
+    for (idx=0; idx<N_AXIS; idx++) {
+      if ((idx != A_MOTOR) && (idx != B_MOTOR)) { step_event_count = max(step_event_count, labs(delta_steps[idx])); }
+    }
+  #else
+    for (idx=0; idx<N_AXIS; idx++) { step_event_count = max(step_event_count, labs(delta_steps[idx])); }
+  #endif
+  return(step_event_count/PLAN_MAX_BLOCK_STEPS + 1);
+}
+#endif
 
 
 /* Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
@@ -318,11 +809,17 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   plan_block_t *block = &block_buffer[block_buffer_head];
   memset(block,0,sizeof(plan_block_t)); // Zero all block values.
   block->condition = pl_data->condition;
-  block->spindle_speed = pl_data->spindle_speed;
-  block->line_number = pl_data->line_number;
+  #ifdef COMPACT_PLANNER_BLOCK
+    plan_pack_speed(&block->spindle_speed, pl_data->spindle_speed);
+    plan_pack_uint24(&block->line_number, pl_data->line_number);
+  #else
+    block->spindle_speed = pl_data->spindle_speed;
+    block->line_number = pl_data->line_number;
+  #endif
 
   // Compute and store initial move distance data.
   int32_t target_steps[N_AXIS], position_steps[N_AXIS];
+  uint32_t steps[N_AXIS], step_event_count = 0;
   float unit_vec[N_AXIS], delta_mm;
   uint8_t idx;
 
@@ -340,8 +837,8 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   #ifdef COREXY
     target_steps[A_MOTOR] = lround(target[A_MOTOR]*settings.steps_per_mm[A_MOTOR]);
     target_steps[B_MOTOR] = lround(target[B_MOTOR]*settings.steps_per_mm[B_MOTOR]);
-    block->steps[A_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) + (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
-    block->steps[B_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) - (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
+    steps[A_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) + (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
+    steps[B_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) - (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
   #endif
 
   for (idx=0; idx<N_AXIS; idx++) {
@@ -351,21 +848,21 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     #ifdef COREXY
       if ( !(idx == A_MOTOR) && !(idx == B_MOTOR) ) {
         target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
-        block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
+        steps[idx] = labs(target_steps[idx]-position_steps[idx]);
       }
-      block->step_event_count = max(block->step_event_count, block->steps[idx]);
+      step_event_count = max(step_event_count, steps[idx]);
       if (idx == A_MOTOR) {
-        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] + target_steps[Y_AXIS]-position_steps[Y_AXIS])/settings.steps_per_mm[idx];
+        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] + target_steps[Y_AXIS]-position_steps[Y_AXIS])*settings_derived.mm_per_step[idx];
       } else if (idx == B_MOTOR) {
-        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] - target_steps[Y_AXIS]+position_steps[Y_AXIS])/settings.steps_per_mm[idx];
+        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] - target_steps[Y_AXIS]+position_steps[Y_AXIS])*settings_derived.mm_per_step[idx];
       } else {
-        delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
+        delta_mm = (target_steps[idx] - position_steps[idx])*settings_derived.mm_per_step[idx];
       }
     #else
       target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
-      block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
-      block->step_event_count = max(block->step_event_count, block->steps[idx]);
-      delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
+      steps[idx] = labs(target_steps[idx]-position_steps[idx]);
+      step_event_count = max(step_event_count, steps[idx]);
+      delta_mm = (target_steps[idx] - position_steps[idx])*settings_derived.mm_per_step[idx];
 	  #endif
     unit_vec[idx] = delta_mm; // Store unit vector numerator
 
@@ -378,22 +875,46 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   }
 
   // Bail if this is a zero-length block. Highly unlikely to occur.
-  if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+  if (step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+  #ifdef PLANNER_COALESCE_TOLERANCE
+    if (plan_coalesce_line(block, steps, unit_vec, target_steps, pl_data->feed_rate)) { return(PLAN_OK); }
+  #endif
+  #ifdef PLAN_MAX_BLOCK_STEPS
+    // mc_line() splits longer line motions. Only a system motion gets here, and is not executed.
+    if (step_event_count > PLAN_MAX_BLOCK_STEPS) { return(PLAN_EMPTY_BLOCK); }
+  #endif
+  #ifdef COMPACT_PLANNER_BLOCK
+    for (idx=0; idx<N_AXIS; idx++) { plan_pack_uint24(&block->steps[idx], steps[idx]); }
+  #else
+    memcpy(block->steps, steps, sizeof(steps));
+    block->step_event_count = step_event_count;
+  #endif
 
   // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
   // down such that no individual axes maximum values are exceeded with respect to the line direction.
   // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
   // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
   block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
-  block->acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
-  block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+  block->acceleration = limit_value_by_axis_maximum(settings_derived.inv_acceleration, unit_vec);
+  #ifdef S_CURVE_ACCELERATION
+    block->jerk = limit_value_by_axis_maximum(settings_derived.inv_jerk, unit_vec);
+  #endif
+  float rapid_rate = limit_value_by_axis_maximum(settings_derived.inv_max_rate, unit_vec);
 
   // Store programmed rate.
-  if (block->condition & PL_COND_FLAG_RAPID_MOTION) { block->programmed_rate = block->rapid_rate; }
+  float programmed_rate;
+  if (block->condition & PL_COND_FLAG_RAPID_MOTION) { programmed_rate = rapid_rate; }
   else { 
-    block->programmed_rate = pl_data->feed_rate;
-    if (block->condition & PL_COND_FLAG_INVERSE_TIME) { block->programmed_rate *= block->millimeters; }
+    programmed_rate = pl_data->feed_rate;
+    if (block->condition & PL_COND_FLAG_INVERSE_TIME) { programmed_rate *= block->millimeters; }
   }
+  #ifdef COMPACT_PLANNER_BLOCK
+    plan_pack_speed(&block->rapid_rate, rapid_rate);
+    plan_pack_speed(&block->programmed_rate, programmed_rate);
+  #else
+    block->rapid_rate = rapid_rate;
+    block->programmed_rate = programmed_rate;
+  #endif
 
   // TODO: Need to check this method handling zero junction speeds when starting from rest.
   if ((block_buffer_head == block_buffer_tail) || (block->condition & PL_COND_FLAG_SYSTEM_MOTION)) {
@@ -402,6 +923,9 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     // If system motion, the system motion block always is assumed to start from rest and end at a complete stop.
     block->entry_speed_sqr = 0.0;
     block->max_junction_speed_sqr = 0.0; // Starting from rest. Enforce start from zero velocity.
+    #ifdef PLANNER_CURVATURE_WINDOW
+      if (!(block->condition & PL_COND_FLAG_SYSTEM_MOTION)) { pl.curve_count = 0; }
+    #endif
 
   } else {
     // Compute maximum allowable entry speed at junction by centripetal acceleration approximation.
@@ -443,12 +967,17 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
         block->max_junction_speed_sqr = SOME_LARGE_VALUE;
       } else {
         convert_delta_vector_to_unit_vector(junction_unit_vec);
-        float junction_acceleration = limit_value_by_axis_maximum(settings.acceleration, junction_unit_vec);
+        float junction_acceleration = limit_value_by_axis_maximum(settings_derived.inv_acceleration, junction_unit_vec);
         float sin_theta_d2 = sqrt(0.5*(1.0-junction_cos_theta)); // Trig half angle identity. Always positive.
         block->max_junction_speed_sqr = max( MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED,
                        (junction_acceleration * settings.junction_deviation * sin_theta_d2)/(1.0-sin_theta_d2) );
       }
     }
+    #ifdef PLANNER_CURVATURE_WINDOW
+      // The junction deviation limit only sees this junction. Also keep within the path curvature.
+      block->max_junction_speed_sqr = min(block->max_junction_speed_sqr, max( MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED,
+                                          plan_compute_curve_speed_sqr(target) ));
+    #endif
   }
 
   // Block system motion from updating this data to ensure next g-code motion is computed correctly.
@@ -456,17 +985,40 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     float nominal_speed = plan_compute_profile_nominal_speed(block);
     plan_compute_profile_parameters(block, nominal_speed, pl.previous_nominal_speed);
     pl.previous_nominal_speed = nominal_speed;
+    #ifdef PLANNER_LAZY_OVERRIDES
+      block->override_epoch = pl.override_epoch;
+    #endif
 
     // Update previous path unit_vector and planner position.
     memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
     memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
 
+    #ifdef PLANNER_CURVATURE_WINDOW
+      // Add this block to the curvature window in place of the oldest.
+      memcpy(pl.curve_point[pl.curve_index], target, sizeof(pl.curve_point[0]));
+      if (++pl.curve_index == PLANNER_CURVATURE_WINDOW) { pl.curve_index = 0; }
+      if (pl.curve_count < PLANNER_CURVATURE_WINDOW) { pl.curve_count++; }
+    #endif
+
+    #ifdef PLANNER_COALESCE_TOLERANCE
+      // The following line motions may be merged into this block.
+      for (idx=0; idx<N_AXIS; idx++) { pl.coalesce_delta[idx] = unit_vec[idx]*block->millimeters; }
+      pl.coalesce_error = 0.0;
+      pl.coalesce_feed_rate = pl_data->feed_rate;
+      pl.coalesce_ready = !(block->condition & PL_COND_FLAG_INVERSE_TIME);
+    #endif
+
+    #ifdef REPORT_FIELD_BUFFER_TIME
+      block->time_per_mm = 60000.0/nominal_speed;
+      if (block_buffer_head != block_buffer_tail) { pl.buffer_time += block->millimeters*block->time_per_mm; }
+    #endif
+
     // New block is all set. Update buffer head and next buffer head indices.
     block_buffer_head = next_buffer_head;
     next_buffer_head = plan_next_block_index(block_buffer_head);
 
     // Finish up by recalculating the plan with the new block.
-    planner_recalculate();
+    planner_recalculate(block_buffer_head);
   }
   return(PLAN_OK);
 }
@@ -475,6 +1027,9 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position()
 {
+  #ifdef PLANNER_COALESCE_TOLERANCE
+    pl.coalesce_ready = false; // The last block no longer ends at the planner position.
+  #endif
   // TODO: For motor configurations not in the same coordinate frame as the machine position,
   // this function needs to be updated to accomodate the difference.
   uint8_t idx;
@@ -495,16 +1050,29 @@ void plan_sync_position()
 
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available()
+plan_index_t plan_get_block_buffer_available()
 {
   if (block_buffer_head >= block_buffer_tail) { return((BLOCK_BUFFER_SIZE-1)-(block_buffer_head-block_buffer_tail)); }
   return((block_buffer_tail-block_buffer_head-1));
 }
 
 
+#ifdef REPORT_FIELD_BUFFER_TIME
+// Returns the execution time of the planner buffer at the nominal speeds of its blocks. The buffer
+// tail is counted from its remaining distance, which the segment generator updates. Acceleration
+// and override changes after a block was planned are not included, so this is an estimate.
+float plan_get_buffer_time()
+{
+  if (block_buffer_head == block_buffer_tail) { return(0.0); }
+  plan_block_t *block = &block_buffer[block_buffer_tail];
+  return(max(pl.buffer_time,0.0) + block->millimeters*block->time_per_mm); // May round below zero.
+}
+#endif
+
+
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count()
+plan_index_t plan_get_block_buffer_count()
 {
   if (block_buffer_head >= block_buffer_tail) { return(block_buffer_head-block_buffer_tail); }
   return(BLOCK_BUFFER_SIZE - (block_buffer_tail-block_buffer_head));
@@ -518,5 +1086,12 @@ void plan_cycle_reinitialize()
   // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
   st_update_plan_block_parameters();
   block_buffer_planned = block_buffer_tail;
-  planner_recalculate();
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    // Override changes may lower the entry speed limits anywhere in the buffer. Plan it all now.
+    block_buffer_resume = block_buffer_tail;
+    planner_recalculate(block_buffer_head);
+    while (block_buffer_resume != block_buffer_planned) { plan_resume_recalculation(); }
+  #else
+    planner_recalculate(block_buffer_head);
+  #endif
 }
@@ -28,6 +28,14 @@
   #define BLOCK_BUFFER_SIZE 36
 #endif
 
+// Index into the planner ring buffer. Widened to 16 bits for buffers of more than 255 blocks, at a
+// small cost in planning time.
+#if BLOCK_BUFFER_SIZE > 255
+  typedef uint16_t plan_index_t;
+#else
+  typedef uint8_t plan_index_t;
+#endif
+
 // Returned status message from planner.
 #define PLAN_OK true
 #define PLAN_EMPTY_BLOCK false
@@ -46,13 +54,32 @@
 #define PL_COND_ACCESSORY_MASK (PL_COND_FLAG_SPINDLE_CW|PL_COND_FLAG_SPINDLE_CCW|PL_COND_FLAG_COOLANT_FLOOD|PL_COND_FLAG_COOLANT_MIST)
 
 
+#ifdef COMPACT_PLANNER_BLOCK
+  // Packed 24-bit unsigned value. Holds step counts and line numbers, or speeds in fixed-point with
+  // 8 fractional bits, i.e. up to 65535.996 mm/min or rpm in steps of 1/256.
+  typedef struct {
+    uint8_t byte[3];
+  } plan_uint24_t;
+#endif
+
+// Largest step count along an axis a planner block can hold. mc_line() splits longer motions.
+#ifdef STEPPER_FIXED_POINT_PREP
+  #define PLAN_MAX_BLOCK_STEPS 0x7FFFFF // Positions in 1/256 steps are int32 in the segment generator.
+#elif defined(COMPACT_PLANNER_BLOCK)
+  #define PLAN_MAX_BLOCK_STEPS 0xFFFFFF // Packed 24-bit step counts
+#endif
+
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
 // are as specified in the source g-code.
 typedef struct {
   // Fields used by the bresenham algorithm for tracing the line
   // NOTE: Used by stepper algorithm to execute the block correctly. Do not alter these values.
-  uint32_t steps[N_AXIS];    // Step count along each axis
-  uint32_t step_event_count; // The maximum step axis count and number of steps required to complete this block.
+  #ifdef COMPACT_PLANNER_BLOCK
+    plan_uint24_t steps[N_AXIS]; // Step count along each axis. The step event count is their maximum.
+  #else
+    uint32_t steps[N_AXIS];    // Step count along each axis
+    uint32_t step_event_count; // The maximum step axis count and number of steps required to complete this block.
+  #endif
   #ifdef DEFAULTS_RAMPS_BOARD
     uint8_t direction_bits[N_AXIS];    // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
   #else
@@ -60,7 +87,11 @@ typedef struct {
   #endif // DEFAULTS_RAMPS_BOARD
   // Block condition data to ensure correct execution depending on states and overrides.
   uint8_t condition;      // Block bitflag variable defining block run conditions. Copied from pl_line_data.
-  int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
+  #ifdef COMPACT_PLANNER_BLOCK
+    plan_uint24_t line_number; // Line numbers never exceed 24 bits. See MAX_LINE_NUMBER in gcode.c.
+  #else
+    int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
+  #endif
 
   // Fields used by the motion planner to manage acceleration. Some of these values may be updated
   // by the stepper module during execution of special motion cases for replanning purposes.
@@ -68,18 +99,51 @@ typedef struct {
   float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
                              //   neighboring nominal speeds with overrides in (mm/min)^2
   float acceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
+  #ifdef S_CURVE_ACCELERATION
+    float jerk;              // Axis-limit adjusted line jerk in (mm/min^3). Does not change.
+  #endif
   float millimeters;         // The remaining distance for this block to be executed in (mm).
                              // NOTE: This value may be altered by stepper algorithm during execution.
 
   // Stored rate limiting data used by planner when changes occur.
   float max_junction_speed_sqr; // Junction entry speed limit based on direction vectors in (mm/min)^2
-  float rapid_rate;             // Axis-limit adjusted maximum rate for this block direction in (mm/min)
-  float programmed_rate;        // Programmed rate of this block (mm/min).
+  #ifdef PLANNER_LAZY_OVERRIDES
+    uint8_t override_epoch;     // Override epoch the max entry speed was computed for
+  #endif
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    float time_per_mm;          // Execution time per mm at the nominal speed it was planned with (ms/mm)
+  #endif
+  #ifdef COMPACT_PLANNER_BLOCK
+    plan_uint24_t rapid_rate;      // As below, in fixed-point. Read with the plan_block_*() accessors.
+    plan_uint24_t programmed_rate;
+    plan_uint24_t spindle_speed;
+  #else
+    float rapid_rate;             // Axis-limit adjusted maximum rate for this block direction in (mm/min)
+    float programmed_rate;        // Programmed rate of this block (mm/min).
 
-  // Stored spindle speed data used by spindle overrides and resuming methods.
-  float spindle_speed;    // Block spindle speed. Copied from pl_line_data.
+    // Stored spindle speed data used by spindle overrides and resuming methods.
+    float spindle_speed;    // Block spindle speed. Copied from pl_line_data.
+  #endif
 } plan_block_t;
 
+// Read access to the plan_block_t fields that COMPACT_PLANNER_BLOCK stores in packed form. Without
+// it, they are plain field accesses.
+#ifdef COMPACT_PLANNER_BLOCK
+  #define plan_block_steps(block,idx)         plan_unpack_uint24(&(block)->steps[idx])
+  #define plan_block_step_event_count(block)  plan_get_step_event_count(block)
+  #define plan_block_line_number(block)       ((int32_t)plan_unpack_uint24(&(block)->line_number))
+  #define plan_block_rapid_rate(block)        plan_unpack_speed(&(block)->rapid_rate)
+  #define plan_block_programmed_rate(block)   plan_unpack_speed(&(block)->programmed_rate)
+  #define plan_block_spindle_speed(block)     plan_unpack_speed(&(block)->spindle_speed)
+#else
+  #define plan_block_steps(block,idx)         ((block)->steps[idx])
+  #define plan_block_step_event_count(block)  ((block)->step_event_count)
+  #define plan_block_line_number(block)       ((block)->line_number)
+  #define plan_block_rapid_rate(block)        ((block)->rapid_rate)
+  #define plan_block_programmed_rate(block)   ((block)->programmed_rate)
+  #define plan_block_spindle_speed(block)     ((block)->spindle_speed)
+#endif
+
 
 // Planner data prototype. Must be used when passing new motions to the planner.
 typedef struct {
@@ -87,18 +151,45 @@ typedef struct {
   float spindle_speed;      // Desired spindle speed through line motion.
   int32_t line_number;    // Desired line number to report when executing.
   uint8_t condition;        // Bitflag variable to indicate planner conditions. See defines above.
+  #ifdef PATH_BLENDING
+    float path_tolerance;   // Corner blending tolerance in mm. Zero, if the corner is not blended.
+  #endif
 } plan_line_data_t;
 
+#ifdef PATH_BLENDING
+  // Arc that blends the corner between the last block and a new line motion. It starts where the
+  // shortened last block ends and turns from its direction toward the new line.
+  typedef struct {
+    float start[N_AXIS];   // Arc start point in absolute mm
+    float tangent[N_AXIS]; // Unit vector of the arc direction at its start
+    float normal[N_AXIS];  // Unit vector from the arc start toward its center
+    float radius;          // Arc radius in mm
+    float angle;           // Angle the arc turns through in radians
+  } plan_blend_t;
+#endif
+
 
 // Initialize and reset the motion plan subsystem
 void plan_reset(); // Reset all
 void plan_reset_buffer(); // Reset buffer only.
 
+#ifdef PLAN_MAX_BLOCK_STEPS
+  // Returns the number of equal parts a line motion to target must be split into, so that none
+  // exceeds PLAN_MAX_BLOCK_STEPS. Also returns the planner position in millimeters.
+  uint16_t plan_compute_line_parts(float *target, float *position);
+#endif
+
 // Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
 // in millimeters. Feed rate specifies the speed of the motion. If feed rate is inverted, the feed
 // rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
 uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data);
 
+#ifdef PATH_BLENDING
+  // Prepares to blend the corner between the last block and a line motion to target. Returns true
+  // and the blend arc, after shortening the last block to end at the arc start.
+  uint8_t plan_blend_corner(float *target, plan_line_data_t *pl_data, plan_blend_t *blend);
+#endif
+
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // availible for new blocks.
 void plan_discard_current_block();
@@ -110,7 +201,12 @@ plan_block_t *plan_get_system_motion_block();
 plan_block_t *plan_get_current_block();
 
 // Called periodically by step segment buffer. Mostly used internally by planner.
-uint8_t plan_next_block_index(uint8_t block_index);
+plan_index_t plan_next_block_index(plan_index_t block_index);
+
+#ifdef REPORT_FIELD_BUFFER_TIME
+  // Returns the estimated execution time of the motions in the planner buffer in milliseconds.
+  float plan_get_buffer_time();
+#endif
 
 // Called by step segment buffer when computing executing block velocity profile.
 float plan_get_exec_block_exit_speed_sqr();
@@ -118,6 +214,11 @@ float plan_get_exec_block_exit_speed_sqr();
 // Called by main program during planner calculations and step segment buffer during initialization.
 float plan_compute_profile_nominal_speed(plan_block_t *block);
 
+#ifdef S_CURVE_ACCELERATION
+  // Returns the distance of a jerk-limited ramp between two speeds in the given block.
+  float plan_compute_ramp_distance(plan_block_t *block, float speed, float target_speed);
+#endif
+
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters();
 
@@ -127,17 +228,28 @@ void plan_sync_position();
 // Reinitialize plan with a partially completed block
 void plan_cycle_reinitialize();
 
+#ifdef PLANNER_RECALCULATE_LIMIT
+  // Continue a recalculation that was cut short by PLANNER_RECALCULATE_LIMIT. Called when idle.
+  void plan_resume_recalculation();
+#endif
+
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available();
+plan_index_t plan_get_block_buffer_available();
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count();
+plan_index_t plan_get_block_buffer_count();
 
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
 
 void plan_get_planner_mpos(float *target);
 
+#ifdef COMPACT_PLANNER_BLOCK
+  // Unpack the compact block fields. Use the plan_block_*() accessors above instead.
+  uint32_t plan_unpack_uint24(const plan_uint24_t *packed);
+  float plan_unpack_speed(const plan_uint24_t *packed);
+  uint32_t plan_get_step_event_count(plan_block_t *block);
+#endif
 
 #endif
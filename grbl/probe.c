@@ -60,7 +60,11 @@ void probe_state_monitor()
 {
   if (probe_get_state()) {
     sys_probe_state = PROBE_OFF;
-    memcpy(sys_probe_position, sys_position, sizeof(sys_position));
+    #ifdef STEPPER_DEFERRED_POSITION
+      st_get_position(sys_probe_position);
+    #else
+      memcpy(sys_probe_position, sys_position, sizeof(sys_position));
+    #endif
     bit_true(sys_rt_exec_state, EXEC_MOTION_CANCEL);
   }
 }
@@ -71,6 +71,9 @@ void protocol_main_loop()
   uint8_t line_flags = 0;
   uint8_t char_counter = 0;
   uint8_t c;
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    uint32_t loop_start = latency_now();
+  #endif
   for (;;) {
 
     // Process one line of incoming serial data, as the data becomes available. Performs an
@@ -101,13 +104,26 @@ void protocol_main_loop()
           report_status_message(STATUS_SYSTEM_GC_LOCK);
         } else {
           // Parse and execute g-code block.
-          report_status_message(gc_execute_line(line));
+          #ifdef ENABLE_MAIN_LOOP_PROFILE
+            uint32_t parse_start = latency_now();
+          #endif
+          uint8_t status_code = gc_execute_line(line);
+          #ifdef ENABLE_MAIN_LOOP_PROFILE
+            latency_record(LATENCY_PARSE,parse_start);
+          #endif
+          report_status_message(status_code);
         }
 
         // Reset tracking data for next line.
         line_flags = 0;
         char_counter = 0;
 
+        #ifdef ENABLE_MAIN_LOOP_PROFILE
+          // The serial loop may run many lines back to back, so each line also closes a loop sample.
+          latency_record(LATENCY_LOOP,loop_start);
+          loop_start = latency_now();
+        #endif
+
       } else {
 
         if (line_flags) {
@@ -163,6 +179,11 @@ void protocol_main_loop()
       // Check for sleep conditions and execute auto-park, if timeout duration elapses.
       sleep_check();    
     #endif
+
+    #ifdef ENABLE_MAIN_LOOP_PROFILE
+      latency_record(LATENCY_LOOP,loop_start);
+      loop_start = latency_now();
+    #endif
   }
 
   return; /* Never reached */
@@ -175,10 +196,16 @@ void protocol_buffer_synchronize()
 {
   // If system is queued, ensure cycle resumes if the auto start flag is present.
   protocol_auto_cycle_start();
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_pause();
+  #endif
   do {
     protocol_execute_realtime();   // Check and execute run-time commands
     if (sys.abort) { return; } // Check for system abort
   } while (plan_get_current_block() || (sys.state == STATE_CYCLE));
+  #ifdef ENABLE_MAIN_LOOP_PROFILE
+    latency_resume();
+  #endif
 }
 
 
@@ -226,6 +253,9 @@ void protocol_exec_rt_system()
     // the source of the error to the user. If critical, Grbl disables by entering an infinite
     // loop until system reset/abort.
     sys.state = STATE_ALARM; // Set system alarm state
+    #ifdef ENABLE_EVENT_TRACE
+      event_trace_record(EVENT_ALARM, rt_exec, 0);
+    #endif
     report_alarm_message(rt_exec);
     // Halt everything upon a critical event flag. Currently hard and soft limits flag this.
     if ((rt_exec == EXEC_ALARM_HARD_LIMIT) || (rt_exec == EXEC_ALARM_SOFT_LIMIT)) {
@@ -253,7 +283,13 @@ void protocol_exec_rt_system()
 
     // Execute and serial print status
     if (rt_exec & EXEC_STATUS_REPORT) {
+      #ifdef ENABLE_MAIN_LOOP_PROFILE
+        uint32_t report_start = latency_now();
+      #endif
       report_realtime_status();
+      #ifdef ENABLE_MAIN_LOOP_PROFILE
+        latency_record(LATENCY_REPORT,report_start);
+      #endif
       system_clear_exec_state_flag(EXEC_STATUS_REPORT);
     }
 
@@ -263,6 +299,9 @@ void protocol_exec_rt_system()
 
       // State check for allowable states for hold methods.
       if (!(sys.state & (STATE_ALARM | STATE_CHECK_MODE))) {
+        #ifdef ENABLE_EVENT_TRACE
+          event_trace_record(EVENT_HOLD, rt_exec & (EXEC_MOTION_CANCEL | EXEC_FEED_HOLD | EXEC_SAFETY_DOOR | EXEC_SLEEP), 0);
+        #endif
       
         // If in CYCLE or JOG states, immediately initiate a motion HOLD.
         if (sys.state & (STATE_CYCLE | STATE_JOG)) {
@@ -358,8 +397,14 @@ void protocol_exec_rt_system()
             // Start cycle only if queued motions exist in planner buffer and the motion is not canceled.
             sys.step_control = STEP_CONTROL_NORMAL_OP; // Restore step control to normal operation
             if (plan_get_current_block() && bit_isfalse(sys.suspend,SUSPEND_MOTION_CANCEL)) {
+              #ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+                if (sys.state == STATE_IDLE) { st_segment_buffer_stats_restart(); }
+              #endif
               sys.suspend = SUSPEND_DISABLE; // Break suspend state.
               sys.state = STATE_CYCLE;
+              #ifdef ENABLE_EVENT_TRACE
+                event_trace_record(EVENT_CYCLE_START, 0, 0);
+              #endif
               st_prep_buffer(); // Initialize step segment buffer before beginning cycle.
               st_wake_up();
             } else { // Otherwise, do nothing. Set and resume IDLE state.
@@ -378,6 +423,9 @@ void protocol_exec_rt_system()
       // NOTE: Bresenham algorithm variables are still maintained through both the planner and stepper
       // cycle reinitializations. The stepper path should continue exactly as if nothing has happened.
       // NOTE: EXEC_CYCLE_STOP is set by the stepper subsystem when a cycle or feed hold completes.
+      #ifdef ENABLE_EVENT_TRACE
+        event_trace_record(EVENT_CYCLE_STOP, 0, 0);
+      #endif
       if ((sys.state & (STATE_HOLD|STATE_SAFETY_DOOR|STATE_SLEEP)) && !(sys.soft_limit) && !(sys.suspend & SUSPEND_JOG_CANCEL)) {
         // Hold complete. Set to indicate ready to resume.  Remain in HOLD or DOOR states until user
         // has issued a resume command or reset.
@@ -427,11 +475,17 @@ void protocol_exec_rt_system()
     if (rt_exec & EXEC_RAPID_OVR_LOW) { new_r_override = RAPID_OVERRIDE_LOW; }
 
     if ((new_f_override != sys.f_override) || (new_r_override != sys.r_override)) {
+      #ifdef ENABLE_EVENT_TRACE
+        if (new_f_override != sys.f_override) { event_trace_record(EVENT_FEED_OVERRIDE, 0, new_f_override); }
+        if (new_r_override != sys.r_override) { event_trace_record(EVENT_RAPID_OVERRIDE, 0, new_r_override); }
+      #endif
       sys.f_override = new_f_override;
       sys.r_override = new_r_override;
       sys.report_ovr_counter = 0; // Set to report change immediately
       plan_update_velocity_profile_parameters();
-      plan_cycle_reinitialize();
+      #ifndef PLANNER_LAZY_OVERRIDES
+        plan_cycle_reinitialize(); // Otherwise already re-planning.
+      #endif
     }
   }
 
@@ -450,6 +504,9 @@ void protocol_exec_rt_system()
     last_s_override = max(last_s_override,MIN_SPINDLE_SPEED_OVERRIDE);
 
     if (last_s_override != sys.spindle_speed_ovr) {
+      #ifdef ENABLE_EVENT_TRACE
+        event_trace_record(EVENT_SPINDLE_OVERRIDE, 0, last_s_override);
+      #endif
       sys.spindle_speed_ovr = last_s_override;
       // NOTE: Spindle speed overrides during HOLD state are taken care of by suspend function.
       if (sys.state == STATE_IDLE) { spindle_set_state(gc_state.modal.spindle, gc_state.spindle_speed); }
@@ -495,9 +552,23 @@ void protocol_exec_rt_system()
 
   // Reload step segment buffer
   if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP| STATE_JOG)) {
+    #ifdef ENABLE_MAIN_LOOP_PROFILE
+      uint32_t prep_start = latency_now();
+    #endif
     st_prep_buffer();
+    #ifdef ENABLE_MAIN_LOOP_PROFILE
+      latency_record(LATENCY_PREP,prep_start);
+    #endif
   }
 
+  #ifdef PLANNER_RECALCULATE_LIMIT
+    plan_resume_recalculation(); // Finish planning the blocks a bounded recalculation left behind.
+  #endif
+
+  #ifdef ENABLE_BLOCK_TIMING
+    // Stream completed block timing, after the segment buffer has been refilled.
+    if (block_timing_is_streaming() && block_timing_count()) { report_block_timing(); }
+  #endif
 }
 
 
@@ -528,7 +599,7 @@ static void protocol_exec_rt_suspend()
     restore_spindle_speed = gc_state.spindle_speed;
   } else {
     restore_condition = (block->condition & PL_COND_SPINDLE_MASK) | coolant_get_state();
-    restore_spindle_speed = block->spindle_speed;
+    restore_spindle_speed = plan_block_spindle_speed(block);
   }
   #ifdef DISABLE_LASER_DURING_HOLD
     if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) { 
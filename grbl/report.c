@@ -84,6 +84,7 @@ static void report_util_setting_string(uint8_t n) {
         case 1: printPgmString(PSTR(":mm/min")); break;
         case 2: printPgmString(PSTR(":mm/s^2")); break;
         case 3: printPgmString(PSTR(":mm max")); break;
+        case 4: printPgmString(PSTR(":mm/s^3")); break;
       }
       break;
   }
@@ -113,7 +114,14 @@ void report_status_message(uint8_t status_code)
 {
   switch(status_code) {
     case STATUS_OK: // STATUS_OK
-      printPgmString(PSTR("ok\r\n")); break;
+      #ifdef REPORT_OK_BUFFER_TIME
+        printPgmString(PSTR("ok:"));
+        print_uint32_base10(plan_get_buffer_time());
+        report_util_line_feed();
+      #else
+        printPgmString(PSTR("ok\r\n"));
+      #endif
+      break;
     default:
       printPgmString(PSTR("error:"));
       print_uint8_base10(status_code);
@@ -214,6 +222,9 @@ void report_grbl_settings() {
         case 1: report_util_float_setting(val+idx,settings.max_rate[idx],N_DECIMAL_SETTINGVALUE); break;
         case 2: report_util_float_setting(val+idx,settings.acceleration[idx]/(60*60),N_DECIMAL_SETTINGVALUE); break;
         case 3: report_util_float_setting(val+idx,-settings.max_travel[idx],N_DECIMAL_SETTINGVALUE); break;
+        #ifdef S_CURVE_ACCELERATION
+          case 4: report_util_float_setting(val+idx,settings.jerk[idx]/(60*60*60),N_DECIMAL_SETTINGVALUE); break;
+        #endif
       }
     }
     val += AXIS_SETTINGS_INCREMENT;
@@ -293,6 +304,13 @@ void report_gcode_modes()
   report_util_gcode_modes_G();
   print_uint8_base10(94-gc_state.modal.feed_rate);
 
+  #ifdef PATH_BLENDING
+    if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS) {
+      report_util_gcode_modes_G();
+      print_uint8_base10(64);
+    }
+  #endif
+
   if (gc_state.modal.program_flow) {
     report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
@@ -419,7 +437,7 @@ void report_build_info(char *line)
   #endif
   // NOTE: Compiled values, like override increments/max/min values, may be added at some point later.
   serial_write(',');
-  print_uint8_base10(BLOCK_BUFFER_SIZE-1);
+  print_uint32_base10(BLOCK_BUFFER_SIZE-1);
   serial_write(',');
   print_uint8_base10(RX_BUFFER_SIZE);
 
@@ -445,7 +463,11 @@ void report_realtime_status()
 {
   uint8_t idx;
   int32_t current_position[N_AXIS]; // Copy current state of the system position variable
-  memcpy(current_position,sys_position,sizeof(sys_position));
+  #ifdef STEPPER_DEFERRED_POSITION
+    st_get_position(current_position);
+  #else
+    memcpy(current_position,sys_position,sizeof(sys_position));
+  #endif
   float print_position[N_AXIS];
   system_convert_array_steps_to_mpos(print_position,current_position);
 
@@ -509,17 +531,29 @@ void report_realtime_status()
   #ifdef REPORT_FIELD_BUFFER_STATE
     if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_BUFFER_STATE)) {
       printPgmString(PSTR("|Bf:"));
-      print_uint8_base10(plan_get_block_buffer_available());
+      print_uint32_base10(plan_get_block_buffer_available());
       serial_write(',');
       print_uint8_base10(serial_get_rx_buffer_available());
     }
   #endif
 
+  #ifdef REPORT_FIELD_BUFFER_TIME
+    printPgmString(PSTR("|Bt:"));
+    print_uint32_base10(plan_get_buffer_time());
+  #endif
+
+  #ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+    printPgmString(PSTR("|Sg:"));
+    print_uint8_base10(st_get_segment_buffer_min());
+    serial_write(',');
+    print_uint32_base10(st_get_segment_buffer_underruns());
+  #endif
+
   #ifdef REPORT_FIELD_LINE_NUMBERS
     // Report current line number
     plan_block_t * cur_block = plan_get_current_block();
     if (cur_block != NULL) {
-      uint32_t ln = cur_block->line_number;
+      uint32_t ln = plan_block_line_number(cur_block);
       if (ln > 0) {
         printPgmString(PSTR("|Ln:"));
         printInteger(ln);
@@ -600,9 +634,162 @@ void report_realtime_status()
 }
 
 
+#ifdef ENABLE_MAIN_LOOP_PROFILE
+  // Prints one line per main program stage: [LAT:stage,max usec:bin counts]. See latency.h for bins.
+  void report_latency_histograms()
+  {
+    uint8_t stage, bin;
+    for (stage=0; stage<LATENCY_N_STAGE; stage++) {
+      latency_histogram_t *h = latency_get_histogram(stage);
+      printPgmString(PSTR("[LAT:"));
+      switch (stage) {
+        case LATENCY_LOOP: printPgmString(PSTR("Loop")); break;
+        case LATENCY_PARSE: printPgmString(PSTR("Parse")); break;
+        case LATENCY_PLAN: printPgmString(PSTR("Plan")); break;
+        case LATENCY_PREP: printPgmString(PSTR("Prep")); break;
+        case LATENCY_REPORT: printPgmString(PSTR("Report")); break;
+      }
+      serial_write(',');
+      print_uint32_base10(h->max_usec);
+      serial_write(':');
+      for (bin=0; bin<LATENCY_N_BIN; bin++) {
+        if (bin) { serial_write(','); }
+        print_uint32_base10(h->count[bin]);
+      }
+      report_util_feedback_line_feed();
+    }
+  }
+#endif
+
+
+#ifdef ENABLE_EVENT_TRACE
+  // Prints one line per event, oldest first: [EVT:usec,event,arg,data]. See event_trace.h for the
+  // meaning of arg and data. A final Dump line gives the time of the dump and the number of events
+  // lost to overwriting since the last dump.
+  void report_event_trace()
+  {
+    event_t event;
+    uint8_t n = event_trace_count(); // Events recorded while printing are left for the next dump.
+    while (n-- && event_trace_pop(&event)) {
+      printPgmString(PSTR("[EVT:"));
+      print_uint32_base10(event.usec);
+      serial_write(',');
+      switch (event.type) {
+        case EVENT_BLOCK_LOAD: printPgmString(PSTR("Load")); break;
+        case EVENT_BLOCK_DISCARD: printPgmString(PSTR("Discard")); break;
+        case EVENT_SEGMENT_UNDERRUN: printPgmString(PSTR("Underrun")); break;
+        case EVENT_CYCLE_START: printPgmString(PSTR("Start")); break;
+        case EVENT_CYCLE_STOP: printPgmString(PSTR("Stop")); break;
+        case EVENT_HOLD: printPgmString(PSTR("Hold")); break;
+        case EVENT_FEED_OVERRIDE: printPgmString(PSTR("FeedOvr")); break;
+        case EVENT_RAPID_OVERRIDE: printPgmString(PSTR("RapidOvr")); break;
+        case EVENT_SPINDLE_OVERRIDE: printPgmString(PSTR("SpindleOvr")); break;
+        case EVENT_ALARM: printPgmString(PSTR("Alarm")); break;
+        case EVENT_SERIAL_OVERFLOW: printPgmString(PSTR("RxFull")); break;
+        case EVENT_EEPROM_WRITE: printPgmString(PSTR("EEPROM")); break;
+      }
+      serial_write(',');
+      print_uint8_base10(event.arg);
+      serial_write(',');
+      print_uint32_base10(event.data);
+      report_util_feedback_line_feed();
+    }
+    printPgmString(PSTR("[EVT:"));
+    print_uint32_base10(cycle_clock_usec());
+    printPgmString(PSTR(",Dump,0,"));
+    print_uint32_base10(event_trace_take_lost());
+    report_util_feedback_line_feed();
+  }
+#endif
+
+
+#ifdef ENABLE_BLOCK_TIMING
+  // Prints one line per completed block, oldest first: [BLK:line,planned usec,actual usec]. When
+  // blocks were lost to overwriting since the last report, a [BLK:Lost,count] line comes first.
+  void report_block_timing()
+  {
+    uint16_t lost = block_timing_take_lost();
+    if (lost) {
+      printPgmString(PSTR("[BLK:Lost,"));
+      print_uint32_base10(lost);
+      report_util_feedback_line_feed();
+    }
+    block_timing_t timing;
+    uint8_t n = block_timing_count(); // Blocks completed while printing are left for the next report.
+    while (n-- && block_timing_pop(&timing)) {
+      printPgmString(PSTR("[BLK:"));
+      printInteger(timing.line_number);
+      serial_write(',');
+      print_uint32_base10(timing.planned_usec);
+      serial_write(',');
+      print_uint32_base10(timing.actual_usec);
+      report_util_feedback_line_feed();
+    }
+  }
+#endif
+
+
+#ifdef ENABLE_SRAM_REPORT
+  static void report_sram_line(const char *s, uint16_t value)
+  {
+    printPgmString(PSTR("[MEM:"));
+    printPgmString(s);
+    serial_write(',');
+    print_uint32_base10(value);
+  }
+
+  // Prints the SRAM usage in bytes, one item per line: the total, the static variables, the buffers
+  // of each subsystem (part of the static variables), then the stack and the free SRAM, now and at
+  // the stack high-water mark. The parser includes the protocol line buffer.
+  void report_sram_usage()
+  {
+    uint16_t min_free = sram_get_min_free(); // Before this report adds to the stack.
+    report_sram_line(PSTR("Total"), sram_get_size()); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Static"), sram_get_static_size()); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Planner"), BLOCK_BUFFER_SIZE*sizeof(plan_block_t)); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Segments"), st_get_buffer_footprint()); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Serial"), (RX_BUFFER_SIZE+1)+(TX_BUFFER_SIZE+1)); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Parser"), sizeof(parser_state_t)+sizeof(parser_block_t)+LINE_BUFFER_SIZE); report_util_feedback_line_feed();
+    report_sram_line(PSTR("Stack"), sram_get_stack_size());
+    serial_write(',');
+    print_uint32_base10((sram_get_free()+sram_get_stack_size())-min_free); // Deepest stack since power-up
+    report_util_feedback_line_feed();
+    report_sram_line(PSTR("Free"), sram_get_free());
+    serial_write(',');
+    print_uint32_base10(min_free);
+    report_util_feedback_line_feed();
+  }
+#endif
+
+
 #ifdef DEBUG
+  #ifdef DEBUG_STEPPER_ISR_PROFILE
+    // Prints one ISR profile as min,avg,max CPU cycles and the number of ticks profiled.
+    static void report_isr_profile(st_isr_profile_t *profile)
+    {
+      print_uint32_base10(profile->min);
+      serial_write(',');
+      if (profile->count) { print_uint32_base10(profile->sum/profile->count); }
+      else { serial_write('0'); }
+      serial_write(',');
+      print_uint32_base10(profile->max);
+      serial_write(',');
+      print_uint32_base10(profile->count);
+    }
+  #endif
+
   void report_realtime_debug()
   {
-
+    serial_write('{');
+    #ifdef DEBUG_STEPPER_ISR_PROFILE
+      st_isr_profile_t profile[ISR_PROFILE_COUNT];
+      st_isr_profile_read(profile);
+      printPgmString(PSTR("Tick:"));
+      report_isr_profile(&profile[ISR_PROFILE_BRESENHAM]);
+      printPgmString(PSTR("|Load:"));
+      report_isr_profile(&profile[ISR_PROFILE_SEGMENT_LOAD]);
+    #endif
+    serial_write('}');
+    report_util_line_feed();
   }
 #endif
@@ -124,6 +124,26 @@ void report_execute_startup_message(char *line, uint8_t status_code);
 // Prints build info and user info
 void report_build_info(char *line);
 
+#ifdef ENABLE_MAIN_LOOP_PROFILE
+  // Prints the main loop latency histograms.
+  void report_latency_histograms();
+#endif
+
+#ifdef ENABLE_EVENT_TRACE
+  // Prints and clears the event trace.
+  void report_event_trace();
+#endif
+
+#ifdef ENABLE_BLOCK_TIMING
+  // Prints and clears the timing of completed planner blocks.
+  void report_block_timing();
+#endif
+
+#ifdef ENABLE_SRAM_REPORT
+  // Prints SRAM usage and the stack high-water mark.
+  void report_sram_usage();
+#endif
+
 #ifdef DEBUG
   void report_realtime_debug();
 #endif
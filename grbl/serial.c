@@ -191,6 +191,9 @@ ISR(SERIAL_RX)
           serial_rx_buffer[serial_rx_buffer_head] = data;
           serial_rx_buffer_head = next_head;
         }
+        #ifdef ENABLE_EVENT_TRACE
+          else { event_trace_record(EVENT_SERIAL_OVERFLOW, 0, data); }
+        #endif
       }
   }
 }
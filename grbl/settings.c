@@ -22,6 +22,7 @@
 #include "grbl.h"
 
 settings_t settings;
+settings_derived_t settings_derived;
 
 const __flash settings_t defaults = {\
     .pulse_microseconds = DEFAULT_STEP_PULSE_MICROSECONDS,
@@ -57,7 +58,24 @@ const __flash settings_t defaults = {\
     .acceleration[Z_AXIS] = DEFAULT_Z_ACCELERATION,
     .max_travel[X_AXIS] = (-DEFAULT_X_MAX_TRAVEL),
     .max_travel[Y_AXIS] = (-DEFAULT_Y_MAX_TRAVEL),
-    .max_travel[Z_AXIS] = (-DEFAULT_Z_MAX_TRAVEL)};
+    .max_travel[Z_AXIS] = (-DEFAULT_Z_MAX_TRAVEL),
+    #ifdef S_CURVE_ACCELERATION
+      .jerk[X_AXIS] = DEFAULT_X_JERK,
+      .jerk[Y_AXIS] = DEFAULT_Y_JERK,
+      .jerk[Z_AXIS] = DEFAULT_Z_JERK,
+    #endif
+    };
+
+
+// Writes a checksummed block to EEPROM. Writes stall the main program for ~3.4msec per byte, so
+// they are logged to the event trace.
+static void settings_write_eeprom(unsigned int addr, char *data, unsigned int size)
+{
+  #ifdef ENABLE_EVENT_TRACE
+    event_trace_record(EVENT_EEPROM_WRITE, min(size,255), addr);
+  #endif
+  memcpy_to_eeprom_with_checksum(addr, data, size);
+}
 
 
 // Method to store startup lines into EEPROM
@@ -67,7 +85,7 @@ void settings_store_startup_line(uint8_t n, char *line)
     protocol_buffer_synchronize(); // A startup line may contain a motion and be executing. 
   #endif
   uint32_t addr = n*(LINE_BUFFER_SIZE+1)+EEPROM_ADDR_STARTUP_BLOCK;
-  memcpy_to_eeprom_with_checksum(addr,(char*)line, LINE_BUFFER_SIZE);
+  settings_write_eeprom(addr,(char*)line, LINE_BUFFER_SIZE);
 }
 
 
@@ -76,7 +94,7 @@ void settings_store_startup_line(uint8_t n, char *line)
 void settings_store_build_info(char *line)
 {
   // Build info can only be stored when state is IDLE.
-  memcpy_to_eeprom_with_checksum(EEPROM_ADDR_BUILD_INFO,(char*)line, LINE_BUFFER_SIZE);
+  settings_write_eeprom(EEPROM_ADDR_BUILD_INFO,(char*)line, LINE_BUFFER_SIZE);
 }
 
 
@@ -87,7 +105,23 @@ void settings_write_coord_data(uint8_t coord_select, float *coord_data)
     protocol_buffer_synchronize();
   #endif
   uint32_t addr = coord_select*(sizeof(float)*N_AXIS+1) + EEPROM_ADDR_PARAMETERS;
-  memcpy_to_eeprom_with_checksum(addr,(char*)coord_data, sizeof(float)*N_AXIS);
+  settings_write_eeprom(addr,(char*)coord_data, sizeof(float)*N_AXIS);
+}
+
+
+// Rebuilds the reciprocals of the axis settings. Zero settings give infinite reciprocals, which
+// limit_value_by_axis_maximum() turns back into a zero limit.
+static void settings_update_derived()
+{
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    settings_derived.mm_per_step[idx] = 1.0/settings.steps_per_mm[idx];
+    settings_derived.inv_max_rate[idx] = 1.0/settings.max_rate[idx];
+    settings_derived.inv_acceleration[idx] = 1.0/settings.acceleration[idx];
+    #ifdef S_CURVE_ACCELERATION
+      settings_derived.inv_jerk[idx] = 1.0/settings.jerk[idx];
+    #endif
+  }
 }
 
 
@@ -96,7 +130,8 @@ void settings_write_coord_data(uint8_t coord_select, float *coord_data)
 void write_global_settings()
 {
   eeprom_put_char(0, SETTINGS_VERSION);
-  memcpy_to_eeprom_with_checksum(EEPROM_ADDR_GLOBAL, (char*)&settings, sizeof(settings_t));
+  settings_write_eeprom(EEPROM_ADDR_GLOBAL, (char*)&settings, sizeof(settings_t));
+  settings_update_derived();
 }
 
 
@@ -215,6 +250,11 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
             break;
           case 2: settings.acceleration[parameter] = value*60*60; break; // Convert to mm/min^2 for grbl internal use.
           case 3: settings.max_travel[parameter] = -value; break;  // Store as negative for grbl internal use.
+          #ifdef S_CURVE_ACCELERATION
+            case 4:
+              if (value == 0.0) { return(STATUS_INVALID_STATEMENT); } // Planner divides by jerk.
+              settings.jerk[parameter] = value*60*60*60; break; // Convert to mm/min^3 for grbl internal use.
+          #endif
         }
         break; // Exit while-loop after setting has been configured and proceed to the EEPROM write call.
       } else {
@@ -305,6 +345,8 @@ void settings_init() {
     report_status_message(STATUS_SETTING_READ_FAIL);
     settings_restore(SETTINGS_RESTORE_ALL); // Force restore all EEPROM data.
     report_grbl_settings();
+  } else {
+    settings_update_derived();
   }
 }
 
@@ -30,7 +30,13 @@
 
 // Version of the EEPROM data. Will be used to migrate existing data from older versions of Grbl
 // when firmware is upgraded. Always stored in byte 0 of eeprom
-#define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+// S_CURVE_ACCELERATION adds the axis jerk settings, so it stores a different layout under its own
+// version. Switching the option then restores the defaults instead of loading a mismatched record.
+#ifdef S_CURVE_ACCELERATION
+  #define SETTINGS_VERSION 138 // Version 10 with the jerk settings.
+#else
+  #define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+#endif
 
 // Define bit flag masks for the boolean settings in settings.flag.
 #define BIT_REPORT_INCHES      0
@@ -79,7 +85,11 @@
 // #define SETTING_INDEX_G92    N_COORDINATE_SYSTEM+2  // Coordinate offset (G92.2,G92.3 not supported)
 
 // Define Grbl axis settings numbering scheme. Starts at START_VAL, every INCREMENT, over N_SETTINGS.
-#define AXIS_N_SETTINGS          4
+#ifdef S_CURVE_ACCELERATION
+  #define AXIS_N_SETTINGS        5
+#else
+  #define AXIS_N_SETTINGS        4
+#endif
 #define AXIS_SETTINGS_START_VAL  100 // NOTE: Reserving settings values >= 100 for axis settings. Up to 255.
 #define AXIS_SETTINGS_INCREMENT  10  // Must be greater than the number of axis settings
 
@@ -108,9 +118,25 @@ typedef struct {
   float homing_seek_rate;
   uint16_t homing_debounce_delay;
   float homing_pulloff;
+
+  #ifdef S_CURVE_ACCELERATION
+    float jerk[N_AXIS]; // Last, so the layout of the other settings doesn't depend on the option.
+  #endif
 } settings_t;
 extern settings_t settings;
 
+// Reciprocals of the axis settings, so the planner and position conversions multiply instead
+// of divide. Not stored in EEPROM. Rebuilt whenever the global settings are loaded or written.
+typedef struct {
+  float mm_per_step[N_AXIS];
+  float inv_max_rate[N_AXIS];
+  float inv_acceleration[N_AXIS];
+  #ifdef S_CURVE_ACCELERATION
+    float inv_jerk[N_AXIS];
+  #endif
+} settings_derived_t;
+extern settings_derived_t settings_derived;
+
 // Initialize the configuration subsystem (load settings from EEPROM)
 void settings_init();
 
@@ -0,0 +1,71 @@
+/*
+  sram.c - SRAM usage and stack high-water mark
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_SRAM_REPORT
+
+// SRAM layout symbols provided by the avr-libc linker script.
+extern uint8_t __data_start; // Start of .data, the first static variable
+extern uint8_t _end;         // End of .bss, the last static variable
+extern uint8_t __stack;      // Top of the stack (RAMEND)
+
+
+// Paints the SRAM between the static variables and the top of the stack with SRAM_PAINT. Runs in
+// the .init1 section, straight after reset, before the stack or the zero register are set up. So
+// it must not use either, and is written in assembly.
+void sram_paint() __attribute__ ((naked, used, section (".init1")));
+void sram_paint()
+{
+  __asm__ __volatile__ (
+    "    ldi r30, lo8(_end)     \n"
+    "    ldi r31, hi8(_end)     \n"
+    "    ldi r24, %0            \n"
+    "    ldi r25, hi8(__stack)  \n"
+    "    rjmp 2f                \n"
+    "1:  st Z+, r24             \n"
+    "2:  cpi r30, lo8(__stack)  \n"
+    "    cpc r31, r25           \n"
+    "    brlo 1b                \n"
+    "    breq 1b                \n"
+    :: "M" (SRAM_PAINT)
+  );
+}
+
+
+uint16_t sram_get_size() { return(RAMEND-RAMSTART+1); }
+
+
+uint16_t sram_get_static_size() { return(&_end - &__data_start); }
+
+
+uint16_t sram_get_free() { return(SP - (uint16_t)&_end); }
+
+
+uint16_t sram_get_stack_size() { return((uint16_t)&__stack - SP); }
+
+
+uint16_t sram_get_min_free()
+{
+  // The stack grows down towards the static variables. Its deepest point is the first used byte.
+  uint8_t *p = &_end;
+  while ((p < (uint8_t *)SP) && (*p == SRAM_PAINT)) { p++; }
+  return(p - &_end);
+}
+
+#endif
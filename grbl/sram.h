@@ -0,0 +1,43 @@
+/*
+  sram.h - SRAM usage and stack high-water mark
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sram_h
+#define sram_h
+
+#include "grbl.h"
+
+// Byte written to all free SRAM at power-up. Bytes that still hold it were never used by the stack.
+#define SRAM_PAINT 0xC5
+
+// Returns the total SRAM size in bytes.
+uint16_t sram_get_size();
+
+// Returns the bytes used by static variables (.data and .bss). Grbl does not use a heap.
+uint16_t sram_get_static_size();
+
+// Returns the bytes between the end of the static variables and the top of the stack.
+uint16_t sram_get_free();
+
+// Returns the bytes currently used by the stack.
+uint16_t sram_get_stack_size();
+
+// Returns the fewest free bytes there have been since power-up, i.e. the stack high-water mark.
+// Found by scanning for the painted bytes, starting from the end of the static variables.
+uint16_t sram_get_min_free();
+
+#endif
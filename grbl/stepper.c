@@ -25,6 +25,18 @@
 // Some useful constants.
 #define DT_SEGMENT (1.0/(ACCELERATION_TICKS_PER_SECOND*60.0)) // min/segment
 #define REQ_MM_INCREMENT_SCALAR 1.25
+#ifdef STEPPER_FIXED_POINT_PREP
+  // Fixed-point units of the segment generator. Positions in steps with PREP_POSITION_SHIFT fraction
+  // bits, speeds in steps per segment with PREP_SPEED_SHIFT fraction bits, and times in CPU cycles.
+  #define PREP_POSITION_SHIFT 8
+  #define PREP_SPEED_SHIFT 20
+  #define PREP_CARRY_SHIFT (PREP_SPEED_SHIFT-PREP_POSITION_SHIFT)
+  #define PREP_CARRY_MASK ((1UL<<PREP_CARRY_SHIFT)-1)
+  #define PREP_SEGMENT_CYCLES (F_CPU/ACCELERATION_TICKS_PER_SECOND) // cycles/segment
+  #define PREP_SPEED_SCALE (DT_SEGMENT*(1UL<<PREP_SPEED_SHIFT)) // Speed units per (step/min)
+  #define PREP_SPEED_MAX 0x7fffffff // Keeps the sum of two speeds in range
+  #define PREP_REQ_POSITION_INCREMENT ((int32_t)(REQ_MM_INCREMENT_SCALAR*(1<<PREP_POSITION_SHIFT)))
+#endif
 #define RAMP_ACCEL 0
 #define RAMP_CRUISE 1
 #define RAMP_DECEL 2
@@ -35,6 +47,41 @@
 #define PREP_FLAG_PARKING bit(2)
 #define PREP_FLAG_DECEL_OVERRIDE bit(3)
 
+#ifdef DEFAULTS_RAMPS_BOARD
+  // Axes are grouped by the port of their step pins and, separately, of their direction pins. See
+  // STEP_PORT_GROUP in cpu_map.h. The bits of a group are kept in the per-axis entry of its lowest
+  // axis, so each port is set with a single write. The entries of the other axes stay unused.
+  #define STEP_GROUP_LEAD(i) (STEP_PORT_GROUP(i) == (i))
+  #define STEP_GROUP_BIT(group,i) ((STEP_PORT_GROUP(i) == (group)) ? (1<<STEP_BIT(i)) : 0)
+  #define STEP_GROUP_MASK(i) (STEP_GROUP_BIT(i,0)|STEP_GROUP_BIT(i,1)|STEP_GROUP_BIT(i,2))
+  #define DIRECTION_GROUP_LEAD(i) (DIRECTION_PORT_GROUP(i) == (i))
+  #define DIRECTION_GROUP_BIT(group,i) ((DIRECTION_PORT_GROUP(i) == (group)) ? (1<<DIRECTION_BIT(i)) : 0)
+  #define DIRECTION_GROUP_MASK(i) (DIRECTION_GROUP_BIT(i,0)|DIRECTION_GROUP_BIT(i,1)|DIRECTION_GROUP_BIT(i,2))
+
+  // Set the pins of the group led by axis i to the group bits. Compile to nothing for other axes.
+  #define STEP_GROUP_WRITE(i,bits) \
+    if (STEP_GROUP_LEAD(i)) { STEP_PORT(i) = (STEP_PORT(i) & ~STEP_GROUP_MASK(i)) | (bits)[i]; }
+  #define DIRECTION_GROUP_WRITE(i,bits) \
+    if (DIRECTION_GROUP_LEAD(i)) { DIRECTION_PORT(i) = (DIRECTION_PORT(i) & ~DIRECTION_GROUP_MASK(i)) | (bits)[i]; }
+
+  static const uint8_t step_port_group[N_AXIS] = { STEP_PORT_GROUP(0), STEP_PORT_GROUP(1), STEP_PORT_GROUP(2) };
+  static const uint8_t direction_port_group[N_AXIS] = { DIRECTION_PORT_GROUP(0), DIRECTION_PORT_GROUP(1), DIRECTION_PORT_GROUP(2) };
+#endif
+
+#ifdef STEPPER_STEP_PATTERNS
+  // Step bits of each axis in a step pattern. A pattern holds the step bits of all axes, and each
+  // RAMPS step port group takes its own with the group mask.
+  #ifdef DEFAULTS_RAMPS_BOARD
+    #define STEP_PATTERN_X_BIT (1<<STEP_BIT(X_AXIS))
+    #define STEP_PATTERN_Y_BIT (1<<STEP_BIT(Y_AXIS))
+    #define STEP_PATTERN_Z_BIT (1<<STEP_BIT(Z_AXIS))
+  #else
+    #define STEP_PATTERN_X_BIT (1<<X_STEP_BIT)
+    #define STEP_PATTERN_Y_BIT (1<<Y_STEP_BIT)
+    #define STEP_PATTERN_Z_BIT (1<<Z_STEP_BIT)
+  #endif
+#endif
+
 // Define Adaptive Multi-Axis Step-Smoothing(AMASS) levels and cutoff frequencies. The highest level
 // frequency bin starts at 0Hz and ends at its cutoff frequency. The next lower level frequency bin
 // starts at the next higher cutoff frequency, and so on. The cutoff frequencies for each level must
@@ -61,8 +108,12 @@
   typedef struct {
   uint32_t steps[N_AXIS];
   uint32_t step_event_count;
-  uint8_t direction_bits[N_AXIS];
+  uint8_t direction_bits[N_AXIS]; // By direction port group
   uint8_t is_pwm_rate_adjusted; // Tracks motions that require constant laser power/rate
+  #ifdef ENABLE_BLOCK_TIMING
+    int32_t line_number;
+    uint32_t planned_usec; // Sum of the prepped segment durations
+  #endif
   } st_block_t;
 #else
   typedef struct {
@@ -70,6 +121,10 @@
     uint32_t step_event_count;
     uint8_t direction_bits;
     uint8_t is_pwm_rate_adjusted; // Tracks motions that require constant laser power/rate
+    #ifdef ENABLE_BLOCK_TIMING
+      int32_t line_number;
+      uint32_t planned_usec; // Sum of the prepped segment durations
+    #endif
   } st_block_t;
 #endif // Ramps Board
 
@@ -89,35 +144,49 @@ typedef struct {
     uint8_t prescaler;      // Without AMASS, a prescaler is required to adjust for slow timing.
   #endif
   uint16_t spindle_pwm;
+  #ifdef STEPPER_STEP_PATTERNS
+    uint16_t steps[N_AXIS]; // Steps of each axis in the segment patterns and not yet in sys_position
+  #endif
 } segment_t;
 static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
 typedef struct {
-  // Used by the bresenham line algorithm
-  uint32_t counter_x,        // Counter variables for the bresenham line tracer
-           counter_y,
-           counter_z;
+  #ifdef STEPPER_STEP_PATTERNS
+    uint16_t pattern_index; // Step pattern buffer index of the next ISR tick
+  #else
+    // Used by the bresenham line algorithm
+    uint32_t counter_x,        // Counter variables for the bresenham line tracer
+             counter_y,
+             counter_z;
+  #endif
   #ifdef STEP_PULSE_DELAY
     #ifdef DEFAULTS_RAMPS_BOARD
-      uint8_t step_bits[N_AXIS];  // Stores out_bits output to complete the step pulse delay
+      uint8_t step_bits[N_AXIS];  // Stores out_bits output to complete the step pulse delay. By port group.
     #else
       uint8_t step_bits;  // Stores out_bits output to complete the step pulse delay
     #endif // Ramps Board
   #endif
 
   uint8_t execute_step;     // Flags step execution for each interrupt.
-  uint8_t step_pulse_time;  // Step pulse reset time after step rise
+  #ifdef STEP_PULSE_OUTPUT_COMPARE
+    uint16_t step_pulse_cycles; // Step pulse width in Timer5 ticks
+  #else
+    uint8_t step_pulse_time;  // Step pulse reset time after step rise
+  #endif
   #ifdef DEFAULTS_RAMPS_BOARD
-    uint8_t step_outbits[N_AXIS];         // The next stepping-bits to be output
-    uint8_t dir_outbits[N_AXIS];
+    uint8_t step_outbits[N_AXIS];         // The next stepping-bits to be output, by step port group
+    uint8_t dir_outbits[N_AXIS];          // By direction port group
   #else
     uint8_t step_outbits;         // The next stepping-bits to be output
     uint8_t dir_outbits;
   #endif //Ramps Board
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+  #if defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING) && !defined(STEPPER_STEP_PATTERNS)
     uint32_t steps[N_AXIS];
   #endif
+  #if defined(STEPPER_DEFERRED_POSITION) && !defined(STEPPER_STEP_PATTERNS)
+    uint16_t segment_steps[N_AXIS]; // Steps executed in this segment and not yet in sys_position
+  #endif
 
   uint16_t step_count;       // Steps remaining in line segment motion
   uint8_t exec_block_index; // Tracks the current st_block index. Change indicates new block.
@@ -131,18 +200,72 @@ static volatile uint8_t segment_buffer_tail;
 static uint8_t segment_buffer_head;
 static uint8_t segment_next_head;
 
+#ifdef STEPPER_STEP_PATTERNS
+  // Step pattern ring buffer. Holds the step bits of each ISR tick of the prepped segments, in order.
+  // The tail is the first pattern of the executing segment that is not yet in sys_position. The
+  // main program preps new patterns at the head.
+  static uint8_t step_pattern_buffer[STEP_PATTERN_BUFFER_SIZE];
+  static volatile uint16_t step_pattern_tail;
+  static uint16_t step_pattern_head;
+#endif
+
+#ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+  // Segment buffer starvation statistics. Updated by the stepper ISR as it loads segments.
+  static uint8_t segment_buffer_min;
+  static uint16_t segment_buffer_underruns;
+  static uint8_t segment_buffer_starved; // Set when an underrun has stopped the current job.
+#endif
+
+#ifdef ENABLE_BLOCK_TIMING
+  // Execution timing of the block in the stepper ISR. A block starts when its first segment is
+  // loaded and ends when the next block's first segment is loaded or the stepper goes idle. System
+  // motions, like parking, are not timed.
+  static uint8_t block_timing_open;    // Set while the executing block is being timed
+  static uint8_t block_timing_index;   // Index of the timed block in st_block_buffer
+  static uint8_t block_timing_stalled; // Set when the segment buffer ran dry during the block
+  static uint8_t block_timing_held;    // Set when it ran dry because a hold stopped the motion
+  static uint32_t block_timing_start;
+  static uint32_t block_timing_end;    // Time the segment buffer ran dry
+
+  static void st_block_timing_close(uint32_t end)
+  {
+    if (block_timing_open) {
+      st_block_t *block = &st_block_buffer[block_timing_index];
+      block_timing_record(block->line_number, block->planned_usec, end-block_timing_start);
+      block_timing_open = false;
+    }
+  }
+#endif
+
 // Step and direction port invert masks.
 #ifdef DEFAULTS_RAMPS_BOARD
-  static uint8_t step_port_invert_mask[N_AXIS];
-  static uint8_t dir_port_invert_mask[N_AXIS];
+  static uint8_t step_port_invert_mask[N_AXIS]; // By step port group
+  static uint8_t dir_port_invert_mask[N_AXIS];  // By direction port group
 #else
   static uint8_t step_port_invert_mask;
   static uint8_t dir_port_invert_mask;
 #endif // Ramps Board
 
+#ifdef STEP_PULSE_OUTPUT_COMPARE
+  // Timer5 compare output modes (TCCR5A) that drive the X, Y and Z step pins to the levels in bits
+  // 0, 1 and 2 of the index on a forced compare: set (COM5x = 3) for high, clear (COM5x = 2) for low.
+  #define STEP_OC_MODE(levels) ( ((((levels) & 0x01) ? 3 : 2) << COM5A0) | \
+                                 ((((levels) & 0x02) ? 3 : 2) << COM5B0) | \
+                                 ((((levels) & 0x04) ? 3 : 2) << COM5C0) )
+  static const uint8_t step_oc_mode[8] = { STEP_OC_MODE(0), STEP_OC_MODE(1), STEP_OC_MODE(2), STEP_OC_MODE(3),
+                                           STEP_OC_MODE(4), STEP_OC_MODE(5), STEP_OC_MODE(6), STEP_OC_MODE(7) };
+  #define STEP_OC_INDEX(outbits) (((outbits) >> X_STEP_BIT) & 0x07)
+  #define STEP_OC_FORCE ((1<<FOC5A) | (1<<FOC5B) | (1<<FOC5C))
+  static uint8_t step_oc_idle_mode; // Returns the step pins to idle on the next compare match
+#endif
+
 // Used to avoid ISR nesting of the "Stepper Driver Interrupt". Should never occur though.
 static volatile uint8_t busy;
 
+#ifdef DEBUG_STEPPER_ISR_PROFILE
+  static st_isr_profile_t isr_profile[ISR_PROFILE_COUNT];
+#endif
+
 // Pointers for the step segment being prepped from the planner buffer. Accessed only by the
 // main program. Pointers may be planning segments or planner blocks ahead of what being executed.
 static plan_block_t *pl_block;     // Pointer to the planner block being prepped
@@ -154,16 +277,29 @@ typedef struct {
   uint8_t st_block_index;  // Index of stepper common data block being prepped
   uint8_t recalculate_flag;
 
-  float dt_remainder;
-  float steps_remaining;
+  #ifdef STEPPER_FIXED_POINT_PREP
+    uint32_t dt_remainder;    // (cycles)
+    uint32_t steps_remaining; // Whole steps
+  #else
+    float dt_remainder;
+    float steps_remaining;
+  #endif
   float step_per_mm;
-  float req_mm_increment;
+  #ifndef STEPPER_FIXED_POINT_PREP
+    float req_mm_increment;
+  #endif
 
   #ifdef PARKING_ENABLE
     uint8_t last_st_block_index;
-    float last_steps_remaining;
+    #ifdef STEPPER_FIXED_POINT_PREP
+      uint32_t last_steps_remaining;
+      uint32_t last_dt_remainder;
+      int32_t last_position;
+    #else
+      float last_steps_remaining;
+      float last_dt_remainder;
+    #endif
     float last_step_per_mm;
-    float last_dt_remainder;
   #endif
 
   uint8_t ramp_type;      // Current segment ramp state
@@ -174,9 +310,41 @@ typedef struct {
   float exit_speed;       // Exit speed of executing block (mm/min)
   float accelerate_until; // Acceleration ramp end measured from end of block (mm)
   float decelerate_after; // Deceleration ramp start measured from end of block (mm)
+  #ifdef S_CURVE_ACCELERATION
+    float ramp_mm;          // Start of the current ramp measured from end of block (mm)
+    float ramp_speed;       // Speed at the start of the current ramp (mm/min)
+    float ramp_end_speed;   // Speed at the end of the current ramp (mm/min)
+    float ramp_accel;       // Peak acceleration of the current ramp (mm/min^2)
+    float ramp_duration;    // Duration of the current ramp (min)
+    float ramp_time;        // Time into the current ramp at the end of the segment buffer (min)
+  #endif
+
+  #ifdef STEPPER_FIXED_POINT_PREP
+    // Fixed-point state of the segment generator, in the units of PREP_POSITION_SHIFT and
+    // PREP_SPEED_SHIFT. Converted from the float velocity profile whenever it is computed.
+    int32_t position;                  // End of the segment buffer. Kept in pl_block->millimeters.
+    uint16_t position_carry;           // Distance below the position resolution, for the next segment
+    uint32_t speed;                    // Kept in current_speed
+    uint32_t speed_maximum;
+    uint32_t speed_exit;
+    uint32_t speed_delta;              // Speed change per segment of acceleration
+    int32_t position_accelerate_until;
+    int32_t position_decelerate_after;
+    int32_t position_complete;
+    float mm_per_position;             // Unit conversions of the block, from step_per_mm
+    float mm_per_min_per_speed;
+  #endif
 
   float inv_rate;    // Used by PWM laser mode to speed up segment calculations.
   uint16_t current_spindle_pwm; 
+
+  #ifdef STEPPER_STEP_PATTERNS
+    // Bresenham line tracer of the step patterns. Mirrors the one the stepper ISR would run.
+    uint8_t pattern_block_index; // Stepper block of the last prepped patterns. Change resets the counters.
+    uint32_t counter_x, counter_y, counter_z;
+    uint16_t pattern_wait; // Ticks of a prepped segment that did not fit in the pattern buffer
+    uint8_t pattern_dt_shift; // Segments of the block are shortened by 2^shift to fit the buffer
+  #endif
 } st_prep_t;
 static st_prep_t prep;
 
@@ -220,6 +388,90 @@ static st_prep_t prep;
 */
 
 
+#ifdef STEPPER_DEFERRED_POSITION
+// Adds the steps of a segment of the block to position, signed by the block directions.
+static void st_add_segment_steps(int32_t *position, st_block_t *block, uint16_t *steps)
+{
+  if (block == NULL) { return; } // Nothing executed since the last reset.
+  #ifdef DEFAULTS_RAMPS_BOARD
+    if (block->direction_bits[DIRECTION_PORT_GROUP(X_AXIS)] & (1<<DIRECTION_BIT(X_AXIS))) { position[X_AXIS] -= steps[X_AXIS]; }
+    else { position[X_AXIS] += steps[X_AXIS]; }
+    if (block->direction_bits[DIRECTION_PORT_GROUP(Y_AXIS)] & (1<<DIRECTION_BIT(Y_AXIS))) { position[Y_AXIS] -= steps[Y_AXIS]; }
+    else { position[Y_AXIS] += steps[Y_AXIS]; }
+    if (block->direction_bits[DIRECTION_PORT_GROUP(Z_AXIS)] & (1<<DIRECTION_BIT(Z_AXIS))) { position[Z_AXIS] -= steps[Z_AXIS]; }
+    else { position[Z_AXIS] += steps[Z_AXIS]; }
+  #else
+    if (block->direction_bits & (1<<X_DIRECTION_BIT)) { position[X_AXIS] -= steps[X_AXIS]; }
+    else { position[X_AXIS] += steps[X_AXIS]; }
+    if (block->direction_bits & (1<<Y_DIRECTION_BIT)) { position[Y_AXIS] -= steps[Y_AXIS]; }
+    else { position[Y_AXIS] += steps[Y_AXIS]; }
+    if (block->direction_bits & (1<<Z_DIRECTION_BIT)) { position[Z_AXIS] -= steps[Z_AXIS]; }
+    else { position[Z_AXIS] += steps[Z_AXIS]; }
+  #endif
+}
+
+
+#ifdef STEPPER_STEP_PATTERNS
+// Counts the steps of each axis in the step patterns from index up to end.
+static void st_count_pattern_steps(uint16_t *steps, uint16_t index, uint16_t end)
+{
+  steps[X_AXIS] = steps[Y_AXIS] = steps[Z_AXIS] = 0;
+  while (index != end) {
+    uint8_t pattern = step_pattern_buffer[index];
+    if (pattern & STEP_PATTERN_X_BIT) { steps[X_AXIS]++; }
+    if (pattern & STEP_PATTERN_Y_BIT) { steps[Y_AXIS]++; }
+    if (pattern & STEP_PATTERN_Z_BIT) { steps[Z_AXIS]++; }
+    if (++index == STEP_PATTERN_BUFFER_SIZE) { index = 0; }
+  }
+}
+#endif
+
+
+// Moves the steps executed in the current segment into sys_position. Called by the stepper ISR at
+// the end of each segment, and when the steppers stop with the stepper ISR disabled.
+static void st_update_sys_position()
+{
+  #ifdef STEPPER_STEP_PATTERNS
+    // Only the steps of the executed patterns. The rest of the segment is added when it ends.
+    uint16_t steps[N_AXIS];
+    st_count_pattern_steps(steps, step_pattern_tail, st.pattern_index);
+    st_add_segment_steps(sys_position, st.exec_block, steps);
+    if (st.exec_segment != NULL) {
+      st.exec_segment->steps[X_AXIS] -= steps[X_AXIS];
+      st.exec_segment->steps[Y_AXIS] -= steps[Y_AXIS];
+      st.exec_segment->steps[Z_AXIS] -= steps[Z_AXIS];
+    }
+    step_pattern_tail = st.pattern_index;
+  #else
+    st_add_segment_steps(sys_position, st.exec_block, st.segment_steps);
+    memset(st.segment_steps, 0, sizeof(st.segment_steps));
+  #endif
+}
+
+
+void st_get_position(int32_t *position)
+{
+  uint8_t sreg = SREG;
+  cli(); // The stepper ISR must not count or move steps in between.
+  memcpy(position, sys_position, sizeof(sys_position));
+  #ifdef STEPPER_STEP_PATTERNS
+    // Count the executed patterns with interrupts enabled. The main program does not prep over
+    // them before they are in sys_position, and the ISR does not change them.
+    uint16_t index = step_pattern_tail;
+    uint16_t end = st.pattern_index;
+    st_block_t *block = st.exec_block;
+    SREG = sreg;
+    uint16_t steps[N_AXIS];
+    st_count_pattern_steps(steps, index, end);
+    st_add_segment_steps(position, block, steps);
+  #else
+    st_add_segment_steps(position, st.exec_block, st.segment_steps);
+    SREG = sreg;
+  #endif
+}
+#endif
+
+
 // Stepper state initialization. Cycle should only start if the st.cycle_start flag is
 // enabled. Startup init and limits call this function but shouldn't start the cycle.
 
@@ -261,6 +513,9 @@ void st_wake_up()
     st.step_pulse_time = -(((settings.pulse_microseconds+STEP_PULSE_DELAY-2)*TICKS_PER_MICROSECOND) >> 3);
     // Set delay between direction pin write and step command.
     OCR0A = -(((settings.pulse_microseconds)*TICKS_PER_MICROSECOND) >> 3);
+  #elif defined(STEP_PULSE_OUTPUT_COMPARE)
+    // Set step pulse width. Timer5 runs at the full CPU clock, so no oscilloscope fudge is needed.
+    st.step_pulse_cycles = settings.pulse_microseconds*TICKS_PER_MICROSECOND;
   #else // Normal operation
     // Set step pulse time. Ad hoc computation from oscilloscope. Uses two's complement.
     st.step_pulse_time = -(((settings.pulse_microseconds-2)*TICKS_PER_MICROSECOND) >> 3);
@@ -278,6 +533,9 @@ void st_go_idle()
   TIMSK1 &= ~(1<<OCIE1A); // Disable Timer1 interrupt
   TCCR1B = (TCCR1B & ~((1<<CS12) | (1<<CS11))) | (1<<CS10); // Reset clock to no prescaling.
   busy = false;
+  #ifdef STEPPER_DEFERRED_POSITION
+    st_update_sys_position(); // A stopped segment may not have completed.
+  #endif
 
   // Set stepper driver idle state, disabled or enabled, depending on settings and circumstances.
   bool pin_state = false; // Keep enabled.
@@ -355,17 +613,18 @@ void st_go_idle()
 // with probing and homing cycles that require true real-time positions.
 ISR(TIMER1_COMPA_vect)
 {
-  #ifdef DEFAULTS_RAMPS_BOARD
-    int i;
-  #endif // Ramps Board
+  #ifdef DEBUG_STEPPER_ISR_PROFILE
+    uint16_t isr_start = TCNT5; // Timestamp first, so the profile covers the entire ISR.
+    uint8_t isr_profile_index = ISR_PROFILE_BRESENHAM;
+  #endif
 
   if (busy) { return; } // The busy-flag is used to avoid reentering this interrupt
 
   // Set the direction pins a couple of nanoseconds before we step the steppers
   #ifdef DEFAULTS_RAMPS_BOARD
-    DIRECTION_PORT(0) = (DIRECTION_PORT(0) & ~(1 << DIRECTION_BIT(0))) | st.dir_outbits[0];
-    DIRECTION_PORT(1) = (DIRECTION_PORT(1) & ~(1 << DIRECTION_BIT(1))) | st.dir_outbits[1];
-    DIRECTION_PORT(2) = (DIRECTION_PORT(2) & ~(1 << DIRECTION_BIT(2))) | st.dir_outbits[2];
+    DIRECTION_GROUP_WRITE(0, st.dir_outbits);
+    DIRECTION_GROUP_WRITE(1, st.dir_outbits);
+    DIRECTION_GROUP_WRITE(2, st.dir_outbits);
   #else
     DIRECTION_PORT = (DIRECTION_PORT & ~DIRECTION_MASK) | (st.dir_outbits & DIRECTION_MASK);
   #endif // Ramps Boafd
@@ -373,26 +632,37 @@ ISR(TIMER1_COMPA_vect)
   // Then pulse the stepping pins
   #ifdef DEFAULTS_RAMPS_BOARD
     #ifdef STEP_PULSE_DELAY
-      st.step_bits[0] = (STEP_PORT(0) & ~(1 << STEP_BIT(0))) | st.step_outbits[0]; // Store out_bits to prevent overwriting.
-      st.step_bits[1] = (STEP_PORT(1) & ~(1 << STEP_BIT(1))) | st.step_outbits[1]; // Store out_bits to prevent overwriting.
-      st.step_bits[2] = (STEP_PORT(2) & ~(1 << STEP_BIT(2))) | st.step_outbits[2]; // Store out_bits to prevent overwriting.
+      memcpy(st.step_bits, st.step_outbits, sizeof(st.step_bits)); // Store out_bits to prevent overwriting.
     #else
-      STEP_PORT(0) = (STEP_PORT(0) & ~(1 << STEP_BIT(0))) | st.step_outbits[0];
-      STEP_PORT(1) = (STEP_PORT(1) & ~(1 << STEP_BIT(1))) | st.step_outbits[1];
-      STEP_PORT(2) = (STEP_PORT(2) & ~(1 << STEP_BIT(2))) | st.step_outbits[2];
+      STEP_GROUP_WRITE(0, st.step_outbits);
+      STEP_GROUP_WRITE(1, st.step_outbits);
+      STEP_GROUP_WRITE(2, st.step_outbits);
     #endif
   #else  
     #ifdef STEP_PULSE_DELAY
       st.step_bits = (STEP_PORT & ~STEP_MASK) | st.step_outbits; // Store out_bits to prevent overwriting.
+    #elif defined(STEP_PULSE_OUTPUT_COMPARE)
+      // Force the step pins to their pulse levels through the Timer5 output compare units, then arm
+      // the compare matches to return them to idle after exactly settings.pulse_microseconds. The
+      // pulse ends in hardware, without the Stepper Port Reset Interrupt.
+      uint16_t pulse_end = TCNT5 + st.step_pulse_cycles;
+      OCR5A = pulse_end;
+      OCR5B = pulse_end;
+      OCR5C = pulse_end;
+      TCCR5A = step_oc_mode[STEP_OC_INDEX(st.step_outbits)];
+      TCCR5C = STEP_OC_FORCE;
+      TCCR5A = step_oc_idle_mode;
     #else  // Normal operation
       STEP_PORT = (STEP_PORT & ~STEP_MASK) | st.step_outbits;
     #endif
   #endif // Ramps Board
 
-  // Enable step pulse reset timer so that The Stepper Port Reset Interrupt can reset the signal after
-  // exactly settings.pulse_microseconds microseconds, independent of the main Timer1 prescaler.
-  TCNT0 = st.step_pulse_time; // Reload Timer0 counter
-  TCCR0B = (1<<CS01); // Begin Timer0. Full speed, 1/8 prescaler
+  #ifndef STEP_PULSE_OUTPUT_COMPARE
+    // Enable step pulse reset timer so that The Stepper Port Reset Interrupt can reset the signal after
+    // exactly settings.pulse_microseconds microseconds, independent of the main Timer1 prescaler.
+    TCNT0 = st.step_pulse_time; // Reload Timer0 counter
+    TCCR0B = (1<<CS01); // Begin Timer0. Full speed, 1/8 prescaler
+  #endif
 
   busy = true;
   sei(); // Re-enable interrupts to allow Stepper Port Reset Interrupt to fire on-time.
@@ -402,8 +672,19 @@ ISR(TIMER1_COMPA_vect)
   if (st.exec_segment == NULL) {
     // Anything in the buffer? If so, load and initialize next step segment.
     if (segment_buffer_head != segment_buffer_tail) {
+      #ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+        // Track the lowest fill while there are still planner blocks to prep. Ignores the final drain.
+        if ((sys.state == STATE_CYCLE) && plan_get_current_block()) {
+          uint8_t fill = segment_buffer_head - segment_buffer_tail;
+          if (segment_buffer_head < segment_buffer_tail) { fill += SEGMENT_BUFFER_SIZE; }
+          if (fill < segment_buffer_min) { segment_buffer_min = fill; }
+        }
+      #endif
       // Initialize new step segment and load number of steps to execute
       st.exec_segment = &segment_buffer[segment_buffer_tail];
+      #ifdef DEBUG_STEPPER_ISR_PROFILE
+        isr_profile_index = ISR_PROFILE_SEGMENT_LOAD;
+      #endif
 
       #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
         // With AMASS is disabled, set timer prescaler for segments with slow step frequencies (< 250Hz).
@@ -415,21 +696,40 @@ ISR(TIMER1_COMPA_vect)
       st.step_count = st.exec_segment->n_step; // NOTE: Can sometimes be zero when moving slow.
       // If the new segment starts a new planner block, initialize stepper variables and counters.
       // NOTE: When the segment data index changes, this indicates a new planner block.
+      #ifdef ENABLE_BLOCK_TIMING
+        if (!(sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION)) {
+          uint32_t now = cycle_clock_usec();
+          if (!block_timing_open || (block_timing_index != st.exec_segment->st_block_index)) {
+            // A stall between two blocks is not counted against either.
+            st_block_timing_close(block_timing_stalled ? block_timing_end : now);
+            block_timing_index = st.exec_segment->st_block_index;
+            block_timing_start = now;
+            block_timing_open = true;
+          } else if (block_timing_held) {
+            block_timing_start += now-block_timing_end; // Resumed from a hold. Exclude its time.
+          }
+          block_timing_stalled = false;
+          block_timing_held = false;
+        }
+      #endif
       if ( st.exec_block_index != st.exec_segment->st_block_index ) {
         st.exec_block_index = st.exec_segment->st_block_index;
         st.exec_block = &st_block_buffer[st.exec_block_index];
 
-        // Initialize Bresenham line and distance counters
-        st.counter_x = st.counter_y = st.counter_z = (st.exec_block->step_event_count >> 1);
+        #ifndef STEPPER_STEP_PATTERNS
+          // Initialize Bresenham line and distance counters
+          st.counter_x = st.counter_y = st.counter_z = (st.exec_block->step_event_count >> 1);
+        #endif
       }
       #ifdef DEFAULTS_RAMPS_BOARD
-        for (i = 0; i < N_AXIS; i++)
-          st.dir_outbits[i] = st.exec_block->direction_bits[i] ^ dir_port_invert_mask[i];
+        st.dir_outbits[0] = st.exec_block->direction_bits[0] ^ dir_port_invert_mask[0];
+        if (DIRECTION_GROUP_LEAD(1)) { st.dir_outbits[1] = st.exec_block->direction_bits[1] ^ dir_port_invert_mask[1]; }
+        if (DIRECTION_GROUP_LEAD(2)) { st.dir_outbits[2] = st.exec_block->direction_bits[2] ^ dir_port_invert_mask[2]; }
       #else
         st.dir_outbits = st.exec_block->direction_bits ^ dir_port_invert_mask;
       #endif // Ramps Board
 
-      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      #if defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING) && !defined(STEPPER_STEP_PATTERNS)
         // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
         st.steps[X_AXIS] = st.exec_block->steps[X_AXIS] >> st.exec_segment->amass_level;
         st.steps[Y_AXIS] = st.exec_block->steps[Y_AXIS] >> st.exec_segment->amass_level;
@@ -440,6 +740,33 @@ ISR(TIMER1_COMPA_vect)
       spindle_set_speed(st.exec_segment->spindle_pwm);
 
     } else {
+      #if defined(REPORT_FIELD_SEGMENT_BUFFER_STATE) || defined(ENABLE_EVENT_TRACE)
+        // Underrun. The main program failed to prep segments ahead of a queued planner block.
+        if ((sys.state == STATE_CYCLE) && plan_get_current_block()) {
+          #ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+            segment_buffer_min = 0;
+            if (segment_buffer_underruns < 0xFFFF) { segment_buffer_underruns++; }
+            segment_buffer_starved = true;
+          #endif
+          #ifdef ENABLE_EVENT_TRACE
+            event_trace_record(EVENT_SEGMENT_UNDERRUN, 0, plan_block_line_number(plan_get_current_block()));
+          #endif
+        }
+      #endif
+      #ifdef ENABLE_BLOCK_TIMING
+        // With planner blocks left, the block is left open, unless the next segment turns out to
+        // start a new block. The stall of an underrun counts against it, a hold does not. Otherwise,
+        // motion has completed.
+        if (!(sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION)) {
+          if (plan_get_current_block()) {
+            block_timing_end = cycle_clock_usec();
+            block_timing_stalled = true;
+            block_timing_held = bit_istrue(sys.step_control,STEP_CONTROL_END_MOTION);
+          } else {
+            st_block_timing_close(cycle_clock_usec());
+          }
+        }
+      #endif
       // Segment buffer empty. Shutdown.
       st_go_idle();
       // Ensure pwm is set properly upon completion of rate-controlled motion.
@@ -453,10 +780,23 @@ ISR(TIMER1_COMPA_vect)
   // Check probing state.
   if (sys_probe_state == PROBE_ACTIVE) { probe_state_monitor(); }
 
+  #ifdef STEPPER_STEP_PATTERNS
+    // Output the step pattern prepped for this tick.
+    uint8_t pattern = step_pattern_buffer[st.pattern_index];
+    if (++st.pattern_index == STEP_PATTERN_BUFFER_SIZE) { st.pattern_index = 0; }
+    #ifdef DEFAULTS_RAMPS_BOARD
+      st.step_outbits[0] = pattern & STEP_GROUP_MASK(0);
+      if (STEP_GROUP_LEAD(1)) { st.step_outbits[1] = pattern & STEP_GROUP_MASK(1); }
+      if (STEP_GROUP_LEAD(2)) { st.step_outbits[2] = pattern & STEP_GROUP_MASK(2); }
+    #else
+      st.step_outbits = pattern;
+    #endif // Ramps Board
+  #else
   // Reset step out bits.
   #ifdef DEFAULTS_RAMPS_BOARD
-    for (i = 0; i < N_AXIS; i++)
-      st.step_outbits[i] = 0;
+    st.step_outbits[0] = 0;
+    if (STEP_GROUP_LEAD(1)) { st.step_outbits[1] = 0; }
+    if (STEP_GROUP_LEAD(2)) { st.step_outbits[2] = 0; }
   #else
     st.step_outbits = 0;
   #endif // Ramps Board
@@ -469,17 +809,25 @@ ISR(TIMER1_COMPA_vect)
   #endif
   #ifdef DEFAULTS_RAMPS_BOARD
     if (st.counter_x > st.exec_block->step_event_count) {
-      st.step_outbits[X_AXIS] |= (1<<STEP_BIT(X_AXIS));
+      st.step_outbits[STEP_PORT_GROUP(X_AXIS)] |= (1<<STEP_BIT(X_AXIS));
       st.counter_x -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits[X_AXIS] & (1<<DIRECTION_BIT(X_AXIS))) { sys_position[X_AXIS]--; }
-      else { sys_position[X_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[X_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits[DIRECTION_PORT_GROUP(X_AXIS)] & (1<<DIRECTION_BIT(X_AXIS))) { sys_position[X_AXIS]--; }
+        else { sys_position[X_AXIS]++; }
+      #endif
     }
   #else
     if (st.counter_x > st.exec_block->step_event_count) {
       st.step_outbits |= (1<<X_STEP_BIT);
       st.counter_x -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits & (1<<X_DIRECTION_BIT)) { sys_position[X_AXIS]--; }
-      else { sys_position[X_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[X_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits & (1<<X_DIRECTION_BIT)) { sys_position[X_AXIS]--; }
+        else { sys_position[X_AXIS]++; }
+      #endif
     }
   #endif // Ramps Board
 
@@ -490,17 +838,25 @@ ISR(TIMER1_COMPA_vect)
   #endif
   #ifdef DEFAULTS_RAMPS_BOARD
     if (st.counter_y > st.exec_block->step_event_count) {
-      st.step_outbits[Y_AXIS] |= (1<<STEP_BIT(Y_AXIS));
+      st.step_outbits[STEP_PORT_GROUP(Y_AXIS)] |= (1<<STEP_BIT(Y_AXIS));
       st.counter_y -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits[Y_AXIS] & (1<<DIRECTION_BIT(Y_AXIS))) { sys_position[Y_AXIS]--; }
-      else { sys_position[Y_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[Y_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits[DIRECTION_PORT_GROUP(Y_AXIS)] & (1<<DIRECTION_BIT(Y_AXIS))) { sys_position[Y_AXIS]--; }
+        else { sys_position[Y_AXIS]++; }
+      #endif
     }
   #else
     if (st.counter_y > st.exec_block->step_event_count) {
       st.step_outbits |= (1<<Y_STEP_BIT);
       st.counter_y -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits & (1<<Y_DIRECTION_BIT)) { sys_position[Y_AXIS]--; }
-      else { sys_position[Y_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[Y_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits & (1<<Y_DIRECTION_BIT)) { sys_position[Y_AXIS]--; }
+        else { sys_position[Y_AXIS]++; }
+      #endif
     }
   #endif // Ramps Board
   #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
@@ -510,39 +866,68 @@ ISR(TIMER1_COMPA_vect)
   #endif
   #ifdef DEFAULTS_RAMPS_BOARD
     if (st.counter_z > st.exec_block->step_event_count) {
-      st.step_outbits[Z_AXIS] |= (1<<STEP_BIT(Z_AXIS));
+      st.step_outbits[STEP_PORT_GROUP(Z_AXIS)] |= (1<<STEP_BIT(Z_AXIS));
       st.counter_z -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits[Z_AXIS] & (1<<DIRECTION_BIT(Z_AXIS))) { sys_position[Z_AXIS]--; }
-      else { sys_position[Z_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[Z_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits[DIRECTION_PORT_GROUP(Z_AXIS)] & (1<<DIRECTION_BIT(Z_AXIS))) { sys_position[Z_AXIS]--; }
+        else { sys_position[Z_AXIS]++; }
+      #endif
     }
   #else
     if (st.counter_z > st.exec_block->step_event_count) {
       st.step_outbits |= (1<<Z_STEP_BIT);
       st.counter_z -= st.exec_block->step_event_count;
-      if (st.exec_block->direction_bits & (1<<Z_DIRECTION_BIT)) { sys_position[Z_AXIS]--; }
-      else { sys_position[Z_AXIS]++; }
+      #ifdef STEPPER_DEFERRED_POSITION
+        st.segment_steps[Z_AXIS]++;
+      #else
+        if (st.exec_block->direction_bits & (1<<Z_DIRECTION_BIT)) { sys_position[Z_AXIS]--; }
+        else { sys_position[Z_AXIS]++; }
+      #endif
     }
   #endif // Ramps Board
+  #endif
 
   // During a homing cycle, lock out and prevent desired axes from moving.
   #ifdef DEFAULTS_RAMPS_BOARD
-    for (i = 0; i < N_AXIS; i++)
-    if (sys.state == STATE_HOMING) { st.step_outbits[i] &= sys.homing_axis_lock[i]; }
+    if (sys.state == STATE_HOMING) { // Clear the step bits of locked axes only. Others share their group.
+      st.step_outbits[STEP_PORT_GROUP(X_AXIS)] &= sys.homing_axis_lock[X_AXIS] | ~(1<<STEP_BIT(X_AXIS));
+      st.step_outbits[STEP_PORT_GROUP(Y_AXIS)] &= sys.homing_axis_lock[Y_AXIS] | ~(1<<STEP_BIT(Y_AXIS));
+      st.step_outbits[STEP_PORT_GROUP(Z_AXIS)] &= sys.homing_axis_lock[Z_AXIS] | ~(1<<STEP_BIT(Z_AXIS));
+    }
   #else
     if (sys.state == STATE_HOMING) { st.step_outbits &= sys.homing_axis_lock; }
   #endif // Ramps Board
   st.step_count--; // Decrement step events count
   if (st.step_count == 0) {
     // Segment is complete. Discard current segment and advance segment indexing.
+    #ifdef STEPPER_STEP_PATTERNS
+      st_add_segment_steps(sys_position, st.exec_block, st.exec_segment->steps);
+      step_pattern_tail = st.pattern_index;
+    #elif defined(STEPPER_DEFERRED_POSITION)
+      st_update_sys_position();
+    #endif
     st.exec_segment = NULL;
     if ( ++segment_buffer_tail == SEGMENT_BUFFER_SIZE) { segment_buffer_tail = 0; }
   }
   #ifdef DEFAULTS_RAMPS_BOARD
-    for (i = 0; i < N_AXIS; i++)
-      st.step_outbits[i] ^= step_port_invert_mask[i];  // Apply step port invert mask
+    st.step_outbits[0] ^= step_port_invert_mask[0];  // Apply step port invert mask
+    if (STEP_GROUP_LEAD(1)) { st.step_outbits[1] ^= step_port_invert_mask[1]; }
+    if (STEP_GROUP_LEAD(2)) { st.step_outbits[2] ^= step_port_invert_mask[2]; }
   #else
     st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
   #endif // Ramps Board
+
+  #ifdef DEBUG_STEPPER_ISR_PROFILE
+    // Still protected by the busy-flag. Unsigned math handles a Timer5 wrap during the ISR.
+    uint16_t isr_cycles = TCNT5 - isr_start;
+    st_isr_profile_t *profile = &isr_profile[isr_profile_index];
+    if ((profile->count == 0) || (isr_cycles < profile->min)) { profile->min = isr_cycles; }
+    if (isr_cycles > profile->max) { profile->max = isr_cycles; }
+    profile->sum += isr_cycles;
+    profile->count++;
+  #endif
   busy = false;
 }
 
@@ -557,19 +942,21 @@ ISR(TIMER1_COMPA_vect)
 */
 // This interrupt is enabled by ISR_TIMER1_COMPAREA when it sets the motor port bits to execute
 // a step. This ISR resets the motor port after a short period (settings.pulse_microseconds)
-// completing one step cycle.
+// completing one step cycle. Not used with STEP_PULSE_OUTPUT_COMPARE, where Timer5 ends the pulse.
+#ifndef STEP_PULSE_OUTPUT_COMPARE
 ISR(TIMER0_OVF_vect)
 {
   // Reset stepping pins (leave the direction pins)
   #ifdef DEFAULTS_RAMPS_BOARD
-    STEP_PORT(0) = (STEP_PORT(0) & ~(1 << STEP_BIT(0))) | step_port_invert_mask[0];
-    STEP_PORT(1) = (STEP_PORT(1) & ~(1 << STEP_BIT(1))) | step_port_invert_mask[1];
-    STEP_PORT(2) = (STEP_PORT(2) & ~(1 << STEP_BIT(2))) | step_port_invert_mask[2];
+    STEP_GROUP_WRITE(0, step_port_invert_mask);
+    STEP_GROUP_WRITE(1, step_port_invert_mask);
+    STEP_GROUP_WRITE(2, step_port_invert_mask);
   #else
     STEP_PORT = (STEP_PORT & ~STEP_MASK) | (step_port_invert_mask & STEP_MASK);
   #endif // Ramps Board
   TCCR0B = 0; // Disable Timer0 to prevent re-entering this interrupt when it's not needed.
 }
+#endif
 #ifdef STEP_PULSE_DELAY
   // This interrupt is used only when STEP_PULSE_DELAY is enabled. Here, the step pulse is
   // initiated after the STEP_PULSE_DELAY time period has elapsed. The ISR TIMER2_OVF interrupt
@@ -579,9 +966,9 @@ ISR(TIMER0_OVF_vect)
   ISR(TIMER0_COMPA_vect)
   {
     #ifdef DEFAULTS_RAMPS_BOARD
-      STEP_PORT(0) = st.step_bits[0]; // Begin step pulse.
-      STEP_PORT(1) = st.step_bits[1]; // Begin step pulse.
-      STEP_PORT(2) = st.step_bits[2]; // Begin step pulse.
+      STEP_GROUP_WRITE(0, st.step_bits); // Begin step pulse.
+      STEP_GROUP_WRITE(1, st.step_bits);
+      STEP_GROUP_WRITE(2, st.step_bits);
     #else
       STEP_PORT = st.step_bits; // Begin step pulse.
     #endif // Ramps Board
@@ -594,12 +981,11 @@ void st_generate_step_dir_invert_masks()
 {
   uint8_t idx;
   #ifdef DEFAULTS_RAMPS_BOARD
+    memset(step_port_invert_mask, 0, sizeof(step_port_invert_mask));
+    memset(dir_port_invert_mask, 0, sizeof(dir_port_invert_mask));
     for (idx=0; idx<N_AXIS; idx++) {
-      if (bit_istrue(settings.step_invert_mask,bit(idx))) { step_port_invert_mask[idx] = get_step_pin_mask(idx); }
-      else { step_port_invert_mask[idx] = 0; }
-
-      if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask[idx] = get_direction_pin_mask(idx); }
-      else { dir_port_invert_mask[idx] = 0; }
+      if (bit_istrue(settings.step_invert_mask,bit(idx))) { step_port_invert_mask[step_port_group[idx]] |= get_step_pin_mask(idx); }
+      if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask[direction_port_group[idx]] |= get_direction_pin_mask(idx); }
     }
   #else
     step_port_invert_mask = 0;
@@ -608,6 +994,9 @@ void st_generate_step_dir_invert_masks()
       if (bit_istrue(settings.step_invert_mask,bit(idx))) { step_port_invert_mask |= get_step_pin_mask(idx); }
       if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask |= get_direction_pin_mask(idx); }
     }
+    #ifdef STEP_PULSE_OUTPUT_COMPARE
+      step_oc_idle_mode = step_oc_mode[STEP_OC_INDEX(step_port_invert_mask)];
+    #endif
   #endif // Ramps Board
 }
 
@@ -630,7 +1019,20 @@ void st_reset()
   segment_buffer_tail = 0;
   segment_buffer_head = 0; // empty = tail
   segment_next_head = 1;
+  #ifdef STEPPER_STEP_PATTERNS
+    step_pattern_tail = 0;
+    step_pattern_head = 0; // empty = tail
+  #endif
   busy = false;
+  #ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+    segment_buffer_starved = false;
+    st_segment_buffer_stats_restart();
+  #endif
+  #ifdef ENABLE_BLOCK_TIMING
+    block_timing_open = false;
+    block_timing_stalled = false;
+    block_timing_held = false;
+  #endif
 
   st_generate_step_dir_invert_masks();
   #ifdef DEFAULTS_RAMPS_BOARD
@@ -638,19 +1040,21 @@ void st_reset()
       st.dir_outbits[idx] = dir_port_invert_mask[idx]; // Initialize direction bits to default.
     }
   
-    STEP_PORT(0) = (STEP_PORT(0) & ~(1 << STEP_BIT(0))) | step_port_invert_mask[0];
-    DIRECTION_PORT(0) = (DIRECTION_PORT(0) & ~(1 << DIRECTION_BIT(0))) | dir_port_invert_mask[0];
-  
-    STEP_PORT(1) = (STEP_PORT(1) & ~(1 << STEP_BIT(1))) | step_port_invert_mask[1];
-    DIRECTION_PORT(1) = (DIRECTION_PORT(1) & ~(1 << DIRECTION_BIT(1))) | dir_port_invert_mask[1];
-  
-    STEP_PORT(2) = (STEP_PORT(2) & ~(1 << STEP_BIT(2))) | step_port_invert_mask[2];
-    DIRECTION_PORT(2) = (DIRECTION_PORT(2) & ~(1 << DIRECTION_BIT(2))) | dir_port_invert_mask[2];
+    STEP_GROUP_WRITE(0, step_port_invert_mask);
+    STEP_GROUP_WRITE(1, step_port_invert_mask);
+    STEP_GROUP_WRITE(2, step_port_invert_mask);
+    DIRECTION_GROUP_WRITE(0, dir_port_invert_mask);
+    DIRECTION_GROUP_WRITE(1, dir_port_invert_mask);
+    DIRECTION_GROUP_WRITE(2, dir_port_invert_mask);
   #else
     st.dir_outbits = dir_port_invert_mask; // Initialize direction bits to default.
 
     // Initialize step and direction port pins.
     STEP_PORT = (STEP_PORT & ~STEP_MASK) | step_port_invert_mask;
+    #ifdef STEP_PULSE_OUTPUT_COMPARE
+      TCCR5A = step_oc_idle_mode; // The output compare units drive the step pins. Force them idle.
+      TCCR5C = STEP_OC_FORCE;
+    #endif
     DIRECTION_PORT = (DIRECTION_PORT & ~DIRECTION_MASK) | dir_port_invert_mask;
   #endif // Ramps Board
 }
@@ -686,13 +1090,25 @@ void stepper_init()
   // TCCR1B = (TCCR1B & ~((1<<CS12) | (1<<CS11))) | (1<<CS10); // Set in st_go_idle().
   // TIMSK1 &= ~(1<<OCIE1A);  // Set in st_go_idle().
 
-  // Configure Timer 0: Stepper Port Reset Interrupt
-  TIMSK0 &= ~((1<<OCIE0B) | (1<<OCIE0A) | (1<<TOIE0)); // Disconnect OC0 outputs and OVF interrupt.
-  TCCR0A = 0; // Normal operation
-  TCCR0B = 0; // Disable Timer0 until needed
-  TIMSK0 |= (1<<TOIE0); // Enable Timer0 overflow interrupt
-  #ifdef STEP_PULSE_DELAY
-    TIMSK0 |= (1<<OCIE0A); // Enable Timer0 Compare Match A interrupt
+  #ifdef STEP_PULSE_OUTPUT_COMPARE
+    // Configure Timer 5: Step pulse output compare units, which end the step pulses. Normal mode, no
+    // prescaler. The compare output modes are set by st_reset() and the Stepper Driver Interrupt.
+    TCCR5B = (1<<CS50);
+  #else
+    // Configure Timer 0: Stepper Port Reset Interrupt
+    TIMSK0 &= ~((1<<OCIE0B) | (1<<OCIE0A) | (1<<TOIE0)); // Disconnect OC0 outputs and OVF interrupt.
+    TCCR0A = 0; // Normal operation
+    TCCR0B = 0; // Disable Timer0 until needed
+    TIMSK0 |= (1<<TOIE0); // Enable Timer0 overflow interrupt
+    #ifdef STEP_PULSE_DELAY
+      TIMSK0 |= (1<<OCIE0A); // Enable Timer0 Compare Match A interrupt
+    #endif
+  #endif
+
+  #ifdef DEBUG_STEPPER_ISR_PROFILE
+    // Configure Timer 5: Free-running ISR profiling clock. Normal mode, no prescaler.
+    TCCR5A = 0;
+    TCCR5B = (1<<CS50);
   #endif
 }
 
@@ -717,6 +1133,92 @@ static uint8_t st_next_block_index(uint8_t block_index)
 }
 
 
+#ifdef STEPPER_FIXED_POINT_PREP
+  // Computes the unit conversions of the prepped block from its steps per millimeter.
+  static void st_prep_fixed_point_scales()
+  {
+    prep.mm_per_position = 1.0/(prep.step_per_mm*(1<<PREP_POSITION_SHIFT));
+    prep.mm_per_min_per_speed = 1.0/(prep.step_per_mm*PREP_SPEED_SCALE);
+  }
+
+
+  // Converts a speed (mm/min) of the prepped block to fixed-point.
+  static uint32_t st_prep_fixed_point_speed(float speed)
+  {
+    speed *= prep.step_per_mm*PREP_SPEED_SCALE;
+    if (speed < PREP_SPEED_MAX) { return(lround(speed)); }
+    return(PREP_SPEED_MAX);
+  }
+
+
+  // Converts a distance from the end of the prepped block (mm) to a fixed-point position. A
+  // ramp boundary never lies beyond the current position, regardless of float round-off.
+  static int32_t st_prep_fixed_point_position(float millimeters)
+  {
+    int32_t position = lround(millimeters*(prep.step_per_mm*(1<<PREP_POSITION_SHIFT)));
+    return(min(position, prep.position));
+  }
+
+
+  // Converts the velocity profile of the prepped block, computed in float, to fixed-point.
+  static void st_prep_fixed_point_profile()
+  {
+    prep.speed_maximum = st_prep_fixed_point_speed(prep.maximum_speed);
+    prep.speed_exit = st_prep_fixed_point_speed(prep.exit_speed);
+    prep.speed_delta = st_prep_fixed_point_speed(pl_block->acceleration*DT_SEGMENT);
+    prep.position_accelerate_until = st_prep_fixed_point_position(prep.accelerate_until);
+    prep.position_decelerate_after = st_prep_fixed_point_position(prep.decelerate_after);
+    prep.position_complete = st_prep_fixed_point_position(prep.mm_complete);
+  }
+
+
+  // Scales a quantity per segment to the given time in CPU cycles. Exact for full segments, and
+  // rounded to nearest otherwise, so partial segments don't lose speed or distance on average.
+  static uint32_t st_prep_per_time(uint32_t value, uint32_t time)
+  {
+    if (time == PREP_SEGMENT_CYCLES) { return(value); }
+    return(lround(value*(time*(1.0/PREP_SEGMENT_CYCLES))));
+  }
+
+
+  // Returns the position after traveling at the given average speed for the given time. The
+  // distance below the position resolution is carried over, so slow segments add up exactly.
+  static int32_t st_prep_advance(int32_t position, uint32_t speed, uint32_t time)
+  {
+    uint32_t distance = st_prep_per_time(speed, time) + prep.position_carry;
+    prep.position_carry = distance & PREP_CARRY_MASK;
+    return(position - (int32_t)(distance >> PREP_CARRY_SHIFT));
+  }
+
+
+  // Returns the time in CPU cycles, rounded to nearest, to travel a distance at constant
+  // acceleration between two speeds, given their sum. Only computed at ramp junctions. The start
+  // position was rounded up by st_prep_advance(), so the carry already traveled is subtracted.
+  // Otherwise every junction would add the time of up to one position.
+  static uint32_t st_prep_ramp_time(int32_t distance, uint16_t carry, uint32_t speed_sum)
+  {
+    if (speed_sum == 0) { speed_sum = 1; }
+    float time = (((float)distance*(1UL<<PREP_CARRY_SHIFT))-carry)*((2.0*PREP_SEGMENT_CYCLES)/speed_sum);
+    if (time > 0.0) { return(lround(time)); }
+    return(0);
+  }
+
+
+  // Returns the CPU cycles per step, rounded up, for the given segment time in CPU cycles and
+  // distance in positions.
+  static uint32_t st_prep_step_cycles(uint32_t time, uint32_t distance)
+  {
+    if (time < (1UL << (31-PREP_POSITION_SHIFT))) {
+      return(((time << PREP_POSITION_SHIFT) + distance-1)/distance);
+    }
+    // Segments of over half a second. Divide in two parts to stay in range.
+    uint32_t cycles = time/distance;
+    time -= cycles*distance;
+    return((cycles << PREP_POSITION_SHIFT) + ((time << PREP_POSITION_SHIFT) + distance-1)/distance);
+  }
+#endif
+
+
 #ifdef PARKING_ENABLE
   // Changes the run state of the step segment buffer to execute the special parking motion.
   void st_parking_setup_buffer()
@@ -727,6 +1229,9 @@ static uint8_t st_next_block_index(uint8_t block_index)
       prep.last_steps_remaining = prep.steps_remaining;
       prep.last_dt_remainder = prep.dt_remainder;
       prep.last_step_per_mm = prep.step_per_mm;
+      #ifdef STEPPER_FIXED_POINT_PREP
+        prep.last_position = prep.position;
+      #endif
     }
     // Set flags to execute a parking motion
     prep.recalculate_flag |= PREP_FLAG_PARKING;
@@ -746,7 +1251,13 @@ static uint8_t st_next_block_index(uint8_t block_index)
       prep.dt_remainder = prep.last_dt_remainder;
       prep.step_per_mm = prep.last_step_per_mm;
       prep.recalculate_flag = (PREP_FLAG_HOLD_PARTIAL_BLOCK | PREP_FLAG_RECALCULATE);
-      prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm; // Recompute this value.
+      #ifdef STEPPER_FIXED_POINT_PREP
+        prep.position = prep.last_position;
+        prep.position_carry = 0;
+        st_prep_fixed_point_scales(); // Recompute these values.
+      #else
+        prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm; // Recompute this value.
+      #endif
     } else {
       prep.recalculate_flag = false;
     }
@@ -754,6 +1265,228 @@ static uint8_t st_next_block_index(uint8_t block_index)
   }
 #endif
 
+#ifdef S_CURVE_ACCELERATION
+  // Starts a jerk-limited ramp of the prepped block at the given distance from the end of the block.
+  // The ramp reaches the block acceleration if the speed change is large enough. Otherwise, it
+  // peaks below. See plan_compute_ramp_distance().
+  static void st_begin_ramp(float speed, float target_speed, float mm_start)
+  {
+    prep.ramp_time = 0.0;
+    prep.ramp_mm = mm_start;
+    prep.ramp_speed = speed;
+    prep.ramp_end_speed = target_speed;
+    float delta_speed = fabs(target_speed-speed);
+    prep.ramp_accel = pl_block->acceleration;
+    if (delta_speed*pl_block->jerk < prep.ramp_accel*prep.ramp_accel) { prep.ramp_accel = sqrt(delta_speed*pl_block->jerk); }
+    if (delta_speed > 0.0) { prep.ramp_duration = delta_speed/prep.ramp_accel + prep.ramp_accel/pl_block->jerk; }
+    else { prep.ramp_duration = 0.0; }
+  }
+
+
+  // Returns the distance traveled from the start of the current ramp after the given ramp time, and
+  // sets the current speed. The acceleration rises at the block jerk for accel/jerk, holds, and falls
+  // over the same time at the end of the ramp. In a deceleration ramp, all three change sign.
+  static float st_ramp_distance(float time)
+  {
+    float jerk = pl_block->jerk;
+    float accel = prep.ramp_accel;
+    float ramp_time = accel/jerk; // Duration of the rising and falling acceleration phases
+    if (prep.ramp_end_speed < prep.ramp_speed) { jerk = -jerk; accel = -accel; }
+    if (time < ramp_time) { // Rising acceleration
+      prep.current_speed = prep.ramp_speed + 0.5*jerk*time*time;
+      return(time*(prep.ramp_speed + (1.0/6.0)*jerk*time*time));
+    }
+    if (time <= prep.ramp_duration-ramp_time) { // Constant acceleration
+      prep.current_speed = prep.ramp_speed + accel*(time - 0.5*ramp_time);
+      return(time*(prep.ramp_speed + 0.5*accel*(time-ramp_time)) + (1.0/6.0)*accel*ramp_time*ramp_time);
+    }
+    // Falling acceleration, mirrored from the end of the ramp.
+    time = prep.ramp_duration-time;
+    prep.current_speed = prep.ramp_end_speed - 0.5*jerk*time*time;
+    return(0.5*(prep.ramp_speed+prep.ramp_end_speed)*prep.ramp_duration - time*(prep.ramp_end_speed - (1.0/6.0)*jerk*time*time));
+  }
+
+
+  // Returns the lowest speed towards the target speed that a single ramp from the given speed reaches
+  // within the given distance. Bisection, rounded towards the given speed.
+  static float st_ramp_reachable_speed(float speed, float target_speed, float millimeters)
+  {
+    float reached = speed;
+    uint8_t i;
+    for (i=0; i<12; i++) {
+      float mid_speed = 0.5*(reached+target_speed);
+      if (plan_compute_ramp_distance(pl_block, speed, mid_speed) > millimeters) { target_speed = mid_speed; }
+      else { reached = mid_speed; }
+    }
+    return(reached);
+  }
+
+
+  /* Computes the jerk-limited velocity profile of the prepped block from the current speed, with the
+     same ramp types as the constant acceleration profile. Each ramp is one S-curve from zero to zero
+     acceleration. Since the ramp distances do not add up like v^2 does, the peak speed of a triangle
+     profile is found by bisection, rounded down, which leaves a short cruise between the ramps.
+     When the planner updates the block in the middle of an acceleration ramp, the ramp is kept, if
+     the new profile begins with the same ramp. Otherwise the new profile starts at zero acceleration.
+     NOTE: Blocks are ramped from and to zero acceleration. Many short blocks accelerate slower
+     than a few long ones, so the planner plans with the same ramps, see planner.c.
+  */
+  static void st_prep_scurve_profile(uint8_t recalculate)
+  {
+    float mm_start = pl_block->millimeters;
+    float speed = prep.current_speed;
+    if (recalculate && (prep.ramp_type == RAMP_ACCEL) && !(sys.step_control & STEP_CONTROL_EXECUTE_HOLD)) {
+      // Plan as from the start of the acceleration ramp in progress.
+      mm_start = prep.ramp_mm;
+      speed = prep.ramp_speed;
+    }
+    float ramp_target, ramp_end_speed = prep.ramp_end_speed;
+    prep.mm_complete = 0.0; // Default velocity profile complete at 0.0mm from end of block.
+
+    if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
+      prep.ramp_type = RAMP_DECEL;
+      float decel_dist = mm_start - plan_compute_ramp_distance(pl_block, speed, 0.0);
+      if (decel_dist < 0.0) { // End of feed hold is not in this block.
+        prep.exit_speed = st_ramp_reachable_speed(speed, 0.0, mm_start);
+      } else {
+        prep.mm_complete = decel_dist; // End of feed hold.
+        prep.exit_speed = 0.0;
+      }
+      st_begin_ramp(speed, prep.exit_speed, mm_start);
+      return;
+    }
+
+    // [Normal Operation]
+    prep.ramp_type = RAMP_ACCEL;
+    prep.accelerate_until = mm_start;
+    if (sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION) { prep.exit_speed = 0.0; } // Enforce stop.
+    else { prep.exit_speed = sqrt(plan_get_exec_block_exit_speed_sqr()); }
+    float nominal_speed = plan_compute_profile_nominal_speed(pl_block);
+
+    if (speed > nominal_speed) { // Only occurs during override reductions.
+      // Decelerate to cruise or cruise-decelerate types.
+      prep.ramp_type = RAMP_DECEL_OVERRIDE;
+      prep.maximum_speed = nominal_speed;
+      prep.accelerate_until = mm_start - plan_compute_ramp_distance(pl_block, speed, nominal_speed);
+      prep.decelerate_after = plan_compute_ramp_distance(pl_block, nominal_speed, prep.exit_speed);
+      if (prep.accelerate_until < prep.decelerate_after) {
+        // No room for two ramps. Hold the current speed and decelerate in a single ramp instead.
+        prep.ramp_type = RAMP_CRUISE;
+        prep.maximum_speed = speed;
+        prep.decelerate_after = plan_compute_ramp_distance(pl_block, speed, prep.exit_speed);
+        if (prep.decelerate_after > mm_start) {
+          // Deceleration-only. Compute override block exit speed since it doesn't match the planner exit speed.
+          prep.ramp_type = RAMP_DECEL;
+          prep.exit_speed = st_ramp_reachable_speed(speed, prep.exit_speed, mm_start);
+          prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE; // Flag to load next block as deceleration override.
+        }
+      }
+    } else {
+      float accelerate_dist = plan_compute_ramp_distance(pl_block, speed, nominal_speed);
+      prep.decelerate_after = plan_compute_ramp_distance(pl_block, nominal_speed, prep.exit_speed);
+      if (accelerate_dist+prep.decelerate_after <= mm_start) { // Trapezoid, cruise or single ramp types
+        prep.maximum_speed = nominal_speed;
+        prep.accelerate_until -= accelerate_dist;
+        if (speed == nominal_speed) { prep.ramp_type = RAMP_CRUISE; }
+      } else if (plan_compute_ramp_distance(pl_block, speed, prep.exit_speed) >= mm_start) {
+        // Acceleration-only or deceleration-only types. The plan allows no more than a single ramp.
+        prep.accelerate_until = 0.0;
+        prep.decelerate_after = 0.0;
+        prep.maximum_speed = prep.exit_speed;
+        if (prep.exit_speed < speed) { prep.ramp_type = RAMP_DECEL; }
+      } else { // Triangle type
+        float min_speed = max(speed, prep.exit_speed);
+        prep.maximum_speed = nominal_speed;
+        uint8_t i;
+        for (i=0; i<12; i++) {
+          float mid_speed = 0.5*(min_speed+prep.maximum_speed);
+          if (plan_compute_ramp_distance(pl_block, speed, mid_speed) +
+              plan_compute_ramp_distance(pl_block, mid_speed, prep.exit_speed) > mm_start) { prep.maximum_speed = mid_speed; }
+          else { min_speed = mid_speed; }
+        }
+        prep.maximum_speed = min_speed;
+        prep.accelerate_until -= plan_compute_ramp_distance(pl_block, speed, min_speed);
+        prep.decelerate_after = plan_compute_ramp_distance(pl_block, min_speed, prep.exit_speed);
+      }
+    }
+    ramp_target = (prep.ramp_type == RAMP_DECEL) ? prep.exit_speed : prep.maximum_speed;
+
+    if ((mm_start != pl_block->millimeters) && (prep.ramp_type == RAMP_ACCEL) && (ramp_target == ramp_end_speed)) {
+      return; // Same acceleration ramp. Carry on with it.
+    }
+    if (mm_start != pl_block->millimeters) { // Different ramp. Recompute from the current speed.
+      st_prep_scurve_profile(false);
+      return;
+    }
+    st_begin_ramp(speed, ramp_target, mm_start);
+  }
+#endif
+
+
+#ifdef STEPPER_STEP_PATTERNS
+  // Returns the number of step patterns that fit in the pattern buffer.
+  static uint16_t st_step_pattern_free()
+  {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t tail = step_pattern_tail;
+    SREG = sreg;
+    if (tail <= step_pattern_head) { tail += STEP_PATTERN_BUFFER_SIZE; }
+    return(tail-step_pattern_head-1);
+  }
+
+
+  // Preps the step patterns of a segment of the prepped block, one per ISR tick, by tracing the
+  // block with the Bresenham line algorithm of the stepper ISR. The counters run on from the last
+  // segment and restart with a new block, as in the ISR. Also counts the segment steps per axis.
+  static void st_prep_step_patterns(segment_t *segment)
+  {
+    if (prep.pattern_block_index != segment->st_block_index) {
+      prep.pattern_block_index = segment->st_block_index;
+      prep.counter_x = prep.counter_y = prep.counter_z = (st_prep_block->step_event_count >> 1);
+    }
+    uint32_t step_event_count = st_prep_block->step_event_count;
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      uint32_t steps_x = st_prep_block->steps[X_AXIS] >> segment->amass_level;
+      uint32_t steps_y = st_prep_block->steps[Y_AXIS] >> segment->amass_level;
+      uint32_t steps_z = st_prep_block->steps[Z_AXIS] >> segment->amass_level;
+    #else
+      uint32_t steps_x = st_prep_block->steps[X_AXIS];
+      uint32_t steps_y = st_prep_block->steps[Y_AXIS];
+      uint32_t steps_z = st_prep_block->steps[Z_AXIS];
+    #endif
+    segment->steps[X_AXIS] = segment->steps[Y_AXIS] = segment->steps[Z_AXIS] = 0;
+
+    uint16_t index = step_pattern_head;
+    uint16_t ticks = segment->n_step;
+    while (ticks--) {
+      uint8_t pattern = 0;
+      prep.counter_x += steps_x;
+      if (prep.counter_x > step_event_count) {
+        pattern |= STEP_PATTERN_X_BIT;
+        prep.counter_x -= step_event_count;
+        segment->steps[X_AXIS]++;
+      }
+      prep.counter_y += steps_y;
+      if (prep.counter_y > step_event_count) {
+        pattern |= STEP_PATTERN_Y_BIT;
+        prep.counter_y -= step_event_count;
+        segment->steps[Y_AXIS]++;
+      }
+      prep.counter_z += steps_z;
+      if (prep.counter_z > step_event_count) {
+        pattern |= STEP_PATTERN_Z_BIT;
+        prep.counter_z -= step_event_count;
+        segment->steps[Z_AXIS]++;
+      }
+      step_pattern_buffer[index] = pattern;
+      if (++index == STEP_PATTERN_BUFFER_SIZE) { index = 0; }
+    }
+    step_pattern_head = index;
+  }
+#endif
+
+
 
 /* Prepares step segment buffer. Continuously called from main program.
 
@@ -784,6 +1517,9 @@ void st_prep_buffer()
       if (pl_block == NULL) { return; } // No planner blocks. Exit.
 
       // Check if we need to only recompute the velocity profile or load a new block.
+      #ifdef S_CURVE_ACCELERATION
+        uint8_t recalculate = prep.recalculate_flag & PREP_FLAG_RECALCULATE;
+      #endif
       if (prep.recalculate_flag & PREP_FLAG_RECALCULATE) {
 
         #ifdef PARKING_ENABLE
@@ -797,36 +1533,57 @@ void st_prep_buffer()
 
         // Load the Bresenham stepping data for the block.
         prep.st_block_index = st_next_block_index(prep.st_block_index);
+        #ifdef ENABLE_EVENT_TRACE
+          event_trace_record(EVENT_BLOCK_LOAD, 0, plan_block_line_number(pl_block));
+        #endif
 
         // Prepare and copy Bresenham algorithm segment data from the new planner block, so that
         // when the segment buffer completes the planner block, it may be discarded when the
         // segment buffer finishes the prepped block, but the stepper ISR is still executing it.
         st_prep_block = &st_block_buffer[prep.st_block_index];
+        #ifdef ENABLE_BLOCK_TIMING
+          st_prep_block->line_number = plan_block_line_number(pl_block);
+          st_prep_block->planned_usec = 0;
+        #endif
         uint8_t idx;
         #ifdef DEFAULTS_RAMPS_BOARD
+          memset(st_prep_block->direction_bits, 0, sizeof(st_prep_block->direction_bits));
           for (idx=0; idx<N_AXIS; idx++) {
-            st_prep_block->direction_bits[idx] = pl_block->direction_bits[idx];
+            st_prep_block->direction_bits[direction_port_group[idx]] |= pl_block->direction_bits[idx];
           }
         #else
           st_prep_block->direction_bits = pl_block->direction_bits;
         #endif // Ramps Board
 
+        uint32_t step_event_count = plan_block_step_event_count(pl_block);
         #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-          for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = (pl_block->steps[idx] << 1); }
-          st_prep_block->step_event_count = (pl_block->step_event_count << 1);
+          for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = (plan_block_steps(pl_block,idx) << 1); }
+          st_prep_block->step_event_count = (step_event_count << 1);
         #else
           // With AMASS enabled, simply bit-shift multiply all Bresenham data by the max AMASS
           // level, such that we never divide beyond the original data anywhere in the algorithm.
           // If the original data is divided, we can lose a step from integer roundoff.
-          for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = pl_block->steps[idx] << MAX_AMASS_LEVEL; }
-          st_prep_block->step_event_count = pl_block->step_event_count << MAX_AMASS_LEVEL;
+          for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = plan_block_steps(pl_block,idx) << MAX_AMASS_LEVEL; }
+          st_prep_block->step_event_count = step_event_count << MAX_AMASS_LEVEL;
         #endif
 
         // Initialize segment buffer data for generating the segments.
-        prep.steps_remaining = (float)pl_block->step_event_count;
-        prep.step_per_mm = prep.steps_remaining/pl_block->millimeters;
-        prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm;
-        prep.dt_remainder = 0.0; // Reset for new segment block
+        #ifdef STEPPER_FIXED_POINT_PREP
+          prep.steps_remaining = step_event_count;
+          prep.step_per_mm = step_event_count/pl_block->millimeters;
+          st_prep_fixed_point_scales();
+          prep.position = step_event_count << PREP_POSITION_SHIFT; // Fits, see PLAN_MAX_BLOCK_STEPS.
+          prep.position_carry = 0;
+          prep.dt_remainder = 0; // Reset for new segment block
+        #else
+          prep.steps_remaining = (float)step_event_count;
+          prep.step_per_mm = prep.steps_remaining/pl_block->millimeters;
+          prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm;
+          prep.dt_remainder = 0.0; // Reset for new segment block
+        #endif
+        #ifdef STEPPER_STEP_PATTERNS
+          prep.pattern_dt_shift = 0;
+        #endif
 
         if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE)) {
           // New block loaded mid-hold. Override planner block entry speed to enforce deceleration.
@@ -836,6 +1593,9 @@ void st_prep_buffer()
         } else {
           prep.current_speed = sqrt(pl_block->entry_speed_sqr);
         }
+        #ifdef STEPPER_FIXED_POINT_PREP
+          prep.speed = st_prep_fixed_point_speed(prep.current_speed);
+        #endif
         
         // Setup laser mode variables. PWM rate adjusted motions will always complete a motion with the
         // spindle off. 
@@ -843,7 +1603,7 @@ void st_prep_buffer()
         if (settings.flags & BITFLAG_LASER_MODE) {
           if (pl_block->condition & PL_COND_FLAG_SPINDLE_CCW) { 
             // Pre-compute inverse programmed rate to speed up PWM updating per step segment.
-            prep.inv_rate = 1.0/pl_block->programmed_rate;
+            prep.inv_rate = 1.0/plan_block_programmed_rate(pl_block);
             st_prep_block->is_pwm_rate_adjusted = true; 
           }
         }
@@ -855,6 +1615,9 @@ void st_prep_buffer()
 			 planner has updated it. For a commanded forced-deceleration, such as from a feed
 			 hold, override the planner velocities and decelerate to the target exit speed.
 			*/
+      #ifdef S_CURVE_ACCELERATION
+        st_prep_scurve_profile(recalculate);
+      #else
 			prep.mm_complete = 0.0; // Default velocity profile complete at 0.0mm from end of block.
 			float inv_2_accel = 0.5/pl_block->acceleration;
 			if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
@@ -939,10 +1702,25 @@ void st_prep_buffer()
 					prep.maximum_speed = prep.exit_speed;
 				}
 			}
+      #endif
+      #ifdef STEPPER_FIXED_POINT_PREP
+        st_prep_fixed_point_profile();
+      #endif
       
       bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_PWM); // Force update whenever updating block.
     }
     
+    #ifdef STEPPER_STEP_PATTERNS
+      // Wait for room for the patterns of a segment that did not fit, before computing it again.
+      if (st_step_pattern_free() < prep.pattern_wait) { return; }
+      // Keep the prep state to undo the segment, if its patterns do not fit.
+      st_prep_t prep_undo = prep;
+      uint8_t update_spindle_pwm = sys.step_control & STEP_CONTROL_UPDATE_SPINDLE_PWM;
+      #ifdef ENABLE_BLOCK_TIMING
+        uint32_t planned_usec = st_prep_block->planned_usec;
+      #endif
+    #endif
+
     // Initialize new segment
     segment_t *prep_segment = &segment_buffer[segment_buffer_head];
 
@@ -963,7 +1741,102 @@ void st_prep_buffer()
       the end of planner block (typical) or mid-block at the end of a forced deceleration,
       such as from a feed hold.
     */
+    #ifdef STEPPER_FIXED_POINT_PREP
+    // The same segment generator in fixed-point. A full segment at the current speed takes only
+    // integer additions. Partial segments at ramp junctions are computed in float.
+    uint32_t dt_max = PREP_SEGMENT_CYCLES; // Maximum segment time (cycles)
+    #ifdef STEPPER_STEP_PATTERNS
+      dt_max >>= prep.pattern_dt_shift; // Shortened, if the patterns of a full segment don't fit.
+    #endif
+    uint32_t dt = 0; // Initialize segment time
+    uint32_t time_var = dt_max; // Time worker variable
+    int32_t position_var; // Position worker variable
+    uint32_t speed_var; // Speed worker variable
+    int32_t position = prep.position; // New segment distance from end of block.
+    uint16_t position_carry; // Carry of the position at the start of the ramp step
+    int32_t minimum_position = position-PREP_REQ_POSITION_INCREMENT; // Guarantee at least one step.
+    if (minimum_position < 0) { minimum_position = 0; }
+
+    do {
+      position_carry = prep.position_carry;
+      switch (prep.ramp_type) {
+        case RAMP_DECEL_OVERRIDE:
+          speed_var = st_prep_per_time(prep.speed_delta, time_var);
+          if (prep.speed <= prep.speed_maximum+speed_var) {
+            // Cruise or cruise-deceleration types only for deceleration override.
+            position = prep.position_accelerate_until;
+            prep.position_carry = 0;
+            time_var = st_prep_ramp_time(prep.position-position, position_carry, prep.speed+prep.speed_maximum);
+            prep.ramp_type = RAMP_CRUISE;
+            prep.speed = prep.speed_maximum;
+          } else { // Mid-deceleration override ramp.
+            position = st_prep_advance(position, prep.speed-(speed_var>>1), time_var);
+            prep.speed -= speed_var;
+          }
+          break;
+        case RAMP_ACCEL:
+          // NOTE: Acceleration ramp only computes during first do-while loop.
+          speed_var = st_prep_per_time(prep.speed_delta, time_var);
+          position = st_prep_advance(position, prep.speed+(speed_var>>1), time_var);
+          if (position < prep.position_accelerate_until) { // End of acceleration ramp.
+            // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+            position = prep.position_accelerate_until; // NOTE: 0 at EOB
+            prep.position_carry = 0;
+            time_var = st_prep_ramp_time(prep.position-position, position_carry, prep.speed+prep.speed_maximum);
+            if (position == prep.position_decelerate_after) { prep.ramp_type = RAMP_DECEL; }
+            else { prep.ramp_type = RAMP_CRUISE; }
+            prep.speed = prep.speed_maximum;
+          } else { // Acceleration only.
+            prep.speed += speed_var;
+          }
+          break;
+        case RAMP_CRUISE:
+          position_var = st_prep_advance(position, prep.speed_maximum, time_var);
+          if (position_var < prep.position_decelerate_after) { // End of cruise.
+            // Cruise-deceleration junction or end of block.
+            time_var = st_prep_ramp_time(position-prep.position_decelerate_after, position_carry, 2*prep.speed_maximum);
+            position = prep.position_decelerate_after; // NOTE: 0 at EOB
+            prep.position_carry = 0;
+            prep.ramp_type = RAMP_DECEL;
+          } else { // Cruising only.
+            position = position_var;
+          }
+          break;
+        default: // case RAMP_DECEL:
+          speed_var = st_prep_per_time(prep.speed_delta, time_var);
+          if (prep.speed > speed_var) { // Check if at or below zero speed.
+            position_var = st_prep_advance(position, prep.speed-(speed_var>>1), time_var);
+            if (position_var > prep.position_complete) { // Typical case. In deceleration ramp.
+              position = position_var;
+              prep.speed -= speed_var;
+              break; // Segment complete. Exit switch-case statement. Continue do-while loop.
+            }
+          }
+          // Otherwise, at end of block or end of forced-deceleration.
+          time_var = st_prep_ramp_time(position-prep.position_complete, position_carry, prep.speed+prep.speed_exit);
+          position = prep.position_complete;
+          prep.position_carry = 0;
+          prep.speed = prep.speed_exit;
+      }
+      dt += time_var; // Add computed ramp time to total segment time.
+      if (dt < dt_max) { time_var = dt_max - dt; } // **Incomplete** At ramp junction.
+      else {
+        if (position > minimum_position) { // Check for very slow segments with zero steps.
+          // Increase segment time to ensure at least one step in segment.
+          dt_max += PREP_SEGMENT_CYCLES;
+          time_var = dt_max - dt;
+        } else {
+          break; // **Complete** Exit loop. Segment execution time maxed.
+        }
+      }
+    } while (position > prep.position_complete); // **Complete** Exit loop. Profile complete.
+    prep.current_speed = prep.speed*prep.mm_per_min_per_speed;
+    #else
     float dt_max = DT_SEGMENT; // Maximum segment time
+    #ifdef STEPPER_STEP_PATTERNS
+      // Shortened, if the patterns of a full segment don't fit.
+      if (prep.pattern_dt_shift) { dt_max /= (1 << prep.pattern_dt_shift); }
+    #endif
     float dt = 0.0; // Initialize segment time
     float time_var = dt_max; // Time worker variable
     float mm_var; // mm-Distance worker variable
@@ -973,6 +1846,63 @@ void st_prep_buffer()
     if (minimum_mm < 0.0) { minimum_mm = 0.0; }
 
     do {
+      #ifdef S_CURVE_ACCELERATION
+      // Ramps follow their jerk-limited curve over time. A ramp ends after its duration or at its
+      // end point, whichever comes first, to absorb the round-off between the two.
+      switch (prep.ramp_type) {
+        case RAMP_DECEL_OVERRIDE: // Ends in a cruise at maximum_speed, like an acceleration ramp.
+        case RAMP_ACCEL:
+          speed_var = prep.current_speed;
+          if (prep.ramp_time+time_var < prep.ramp_duration) {
+            mm_var = prep.ramp_mm - st_ramp_distance(prep.ramp_time+time_var);
+            if (mm_var > prep.accelerate_until) { // Mid-ramp.
+              prep.ramp_time += time_var;
+              mm_remaining = mm_var;
+              break;
+            }
+            time_var = 2.0*(mm_remaining-prep.accelerate_until)/(speed_var+prep.maximum_speed);
+          } else {
+            time_var = prep.ramp_duration-prep.ramp_time;
+          }
+          // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+          mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
+          prep.current_speed = prep.maximum_speed;
+          if ((prep.ramp_type == RAMP_ACCEL) && (mm_remaining == prep.decelerate_after)) {
+            prep.ramp_type = RAMP_DECEL;
+            st_begin_ramp(prep.maximum_speed, prep.exit_speed, mm_remaining);
+          } else {
+            prep.ramp_type = RAMP_CRUISE;
+          }
+          break;
+        case RAMP_CRUISE:
+          mm_var = mm_remaining - prep.maximum_speed*time_var;
+          if (mm_var < prep.decelerate_after) { // End of cruise.
+            time_var = (mm_remaining - prep.decelerate_after)/prep.maximum_speed;
+            mm_remaining = prep.decelerate_after; // NOTE: 0.0 at EOB
+            prep.ramp_type = RAMP_DECEL;
+            st_begin_ramp(prep.maximum_speed, prep.exit_speed, mm_remaining);
+          } else { // Cruising only.
+            mm_remaining = mm_var;
+          }
+          break;
+        default: // case RAMP_DECEL:
+          speed_var = prep.current_speed;
+          if (prep.ramp_time+time_var < prep.ramp_duration) {
+            mm_var = prep.ramp_mm - st_ramp_distance(prep.ramp_time+time_var);
+            if (mm_var > prep.mm_complete) { // Typical case. In deceleration ramp.
+              prep.ramp_time += time_var;
+              mm_remaining = mm_var;
+              break;
+            }
+            time_var = 2.0*(mm_remaining-prep.mm_complete)/(speed_var+prep.exit_speed);
+          } else {
+            time_var = prep.ramp_duration-prep.ramp_time;
+          }
+          // At end of block or end of forced-deceleration.
+          mm_remaining = prep.mm_complete;
+          prep.current_speed = prep.exit_speed;
+      }
+      #else
       switch (prep.ramp_type) {
         case RAMP_DECEL_OVERRIDE:
           speed_var = pl_block->acceleration*time_var;
@@ -1033,6 +1963,7 @@ void st_prep_buffer()
           mm_remaining = prep.mm_complete;
           prep.current_speed = prep.exit_speed;
       }
+      #endif
       dt += time_var; // Add computed ramp time to total segment time.
       if (dt < dt_max) { time_var = dt_max - dt; } // **Incomplete** At ramp junction.
       else {
@@ -1046,6 +1977,7 @@ void st_prep_buffer()
         }
       }
     } while (mm_remaining > prep.mm_complete); // **Complete** Exit loop. Profile complete.
+    #endif
 
 
     /* -----------------------------------------------------------------------------------
@@ -1054,7 +1986,7 @@ void st_prep_buffer()
     
     if (st_prep_block->is_pwm_rate_adjusted || (sys.step_control & STEP_CONTROL_UPDATE_SPINDLE_PWM)) {
       if (pl_block->condition & (PL_COND_FLAG_SPINDLE_CW | PL_COND_FLAG_SPINDLE_CCW)) {
-        float rpm = pl_block->spindle_speed;
+        float rpm = plan_block_spindle_speed(pl_block);
         // NOTE: Feed and rapid overrides are independent of PWM value and do not alter laser power/rate.        
         if (st_prep_block->is_pwm_rate_adjusted) { rpm *= (prep.current_speed * prep.inv_rate); }
         // If current_speed is zero, then may need to be rpm_min*(100/MAX_SPINDLE_SPEED_OVERRIDE)
@@ -1079,10 +2011,16 @@ void st_prep_buffer()
        Fortunately, this scenario is highly unlikely and unrealistic in CNC machines
        supported by Grbl (i.e. exceeding 10 meters axis travel at 200 step/mm).
     */
-    float step_dist_remaining = prep.step_per_mm*mm_remaining; // Convert mm_remaining to steps
-    float n_steps_remaining = ceil(step_dist_remaining); // Round-up current steps remaining
-    float last_n_steps_remaining = ceil(prep.steps_remaining); // Round-up last steps remaining
-    prep_segment->n_step = last_n_steps_remaining-n_steps_remaining; // Compute number of steps to execute.
+    #ifdef STEPPER_FIXED_POINT_PREP
+      // With fixed-point, the position already is in steps and only needs rounding up.
+      uint32_t n_steps_remaining = (position + (1<<PREP_POSITION_SHIFT)-1) >> PREP_POSITION_SHIFT;
+      prep_segment->n_step = prep.steps_remaining-n_steps_remaining; // Compute number of steps to execute.
+    #else
+      float step_dist_remaining = prep.step_per_mm*mm_remaining; // Convert mm_remaining to steps
+      float n_steps_remaining = ceil(step_dist_remaining); // Round-up current steps remaining
+      float last_n_steps_remaining = ceil(prep.steps_remaining); // Round-up last steps remaining
+      prep_segment->n_step = last_n_steps_remaining-n_steps_remaining; // Compute number of steps to execute.
+    #endif
 
     // Bail if we are at the end of a feed hold and don't have a step to execute.
     if (prep_segment->n_step == 0) {
@@ -1106,10 +2044,23 @@ void st_prep_buffer()
     // typically very small and do not adversely effect performance, but ensures that Grbl
     // outputs the exact acceleration and velocity profiles as computed by the planner.
     dt += prep.dt_remainder; // Apply previous segment partial step execute time
-    float inv_rate = dt/(last_n_steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
+    #ifdef STEPPER_FIXED_POINT_PREP
+      // Compute CPU cycles per step for the prepped segment, over the distance from the last whole step.
+      uint32_t cycles = st_prep_step_cycles(dt, (prep.steps_remaining << PREP_POSITION_SHIFT) - position);
+      // Time of the partial step at the end of the segment, carried over to the next segment.
+      uint32_t partial_step = (n_steps_remaining << PREP_POSITION_SHIFT) - position;
+      uint32_t dt_remainder;
+      if (cycles < (1UL << (32-PREP_POSITION_SHIFT))) { dt_remainder = (partial_step*cycles) >> PREP_POSITION_SHIFT; }
+      else { dt_remainder = partial_step*(cycles >> PREP_POSITION_SHIFT); }
+    #else
+      float inv_rate = dt/(last_n_steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
 
-    // Compute CPU cycles per step for the prepped segment.
-    uint32_t cycles = ceil( (TICKS_PER_MICROSECOND*1000000*60)*inv_rate ); // (cycles/step)
+      // Compute CPU cycles per step for the prepped segment.
+      uint32_t cycles = ceil( (TICKS_PER_MICROSECOND*1000000*60)*inv_rate ); // (cycles/step)
+    #endif
+    #ifdef ENABLE_BLOCK_TIMING
+      st_prep_block->planned_usec += (prep_segment->n_step*cycles)/TICKS_PER_MICROSECOND;
+    #endif
 
     #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
       // Compute step timing and multi-axis smoothing level.
@@ -1142,19 +2093,57 @@ void st_prep_buffer()
       }
     #endif
 
+    #ifdef STEPPER_STEP_PATTERNS
+      if (prep_segment->n_step > st_step_pattern_free()) {
+        // Undo the segment and compute it again, when the stepper ISR has made room for it.
+        uint16_t n_step = prep_segment->n_step;
+        prep = prep_undo;
+        sys.step_control |= update_spindle_pwm;
+        #ifdef ENABLE_BLOCK_TIMING
+          st_prep_block->planned_usec = planned_usec;
+        #endif
+        if (n_step > STEP_PATTERN_BUFFER_SIZE/2) {
+          // Room for it might never free up. Shorten the segments of the block, and compute it again now.
+          while (n_step > STEP_PATTERN_BUFFER_SIZE/2) {
+            n_step >>= 1;
+            prep.pattern_dt_shift++;
+          }
+          prep.pattern_wait = 0;
+          continue;
+        }
+        prep.pattern_wait = n_step;
+        return;
+      }
+      prep.pattern_wait = 0;
+      st_prep_step_patterns(prep_segment);
+    #endif
+
     // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
     segment_buffer_head = segment_next_head;
     if ( ++segment_next_head == SEGMENT_BUFFER_SIZE ) { segment_next_head = 0; }
 
     // Update the appropriate planner and segment data.
-    pl_block->millimeters = mm_remaining;
-    prep.steps_remaining = n_steps_remaining;
-    prep.dt_remainder = (n_steps_remaining - step_dist_remaining)*inv_rate;
+    #ifdef STEPPER_FIXED_POINT_PREP
+      pl_block->millimeters = position*prep.mm_per_position;
+      prep.position = position;
+      prep.steps_remaining = n_steps_remaining;
+      prep.dt_remainder = dt_remainder;
+    #else
+      pl_block->millimeters = mm_remaining;
+      prep.steps_remaining = n_steps_remaining;
+      prep.dt_remainder = (n_steps_remaining - step_dist_remaining)*inv_rate;
+    #endif
 
     // Check for exit conditions and flag to load next planner block.
+    #ifdef STEPPER_FIXED_POINT_PREP
+    if (position == prep.position_complete) {
+      // End of planner block or forced-termination. No more distance to be executed.
+      if (position > 0) { // At end of forced-termination.
+    #else
     if (mm_remaining == prep.mm_complete) {
       // End of planner block or forced-termination. No more distance to be executed.
       if (mm_remaining > 0.0) { // At end of forced-termination.
+    #endif
         // Reset prep parameters for resuming and then bail. Allow the stepper ISR to complete
         // the segment queue, where realtime protocol will set new state upon receiving the
         // cycle stop flag from the ISR. Prep_segment is blocked until then.
@@ -1189,3 +2178,53 @@ float st_get_realtime_rate()
   }
   return 0.0f;
 }
+
+
+#ifdef DEBUG_STEPPER_ISR_PROFILE
+  // Copies the Stepper Driver Interrupt statistics and restarts them. Called by the debug report.
+  void st_isr_profile_read(st_isr_profile_t *profile)
+  {
+    uint8_t sreg = SREG;
+    cli();
+    memcpy(profile,isr_profile,sizeof(isr_profile));
+    memset(isr_profile,0,sizeof(isr_profile));
+    SREG = sreg;
+  }
+#endif
+
+
+#ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+  // Starts new per-job segment buffer statistics. An underrun stops the cycle and the main program
+  // restarts it from IDLE, so the restart after an underrun continues the statistics of that job.
+  void st_segment_buffer_stats_restart()
+  {
+    if (segment_buffer_starved) {
+      segment_buffer_starved = false;
+      return;
+    }
+    segment_buffer_min = SEGMENT_BUFFER_SIZE-1; // Full buffer
+    segment_buffer_underruns = 0;
+  }
+
+
+  uint8_t st_get_segment_buffer_min() { return(segment_buffer_min); }
+
+
+  uint16_t st_get_segment_buffer_underruns()
+  {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t underruns = segment_buffer_underruns;
+    SREG = sreg;
+    return(underruns);
+  }
+#endif
+
+
+#ifdef ENABLE_SRAM_REPORT
+  #ifdef STEPPER_STEP_PATTERNS
+    uint16_t st_get_buffer_footprint() { return(sizeof(segment_buffer)+sizeof(st_block_buffer)+sizeof(step_pattern_buffer)); }
+  #else
+    uint16_t st_get_buffer_footprint() { return(sizeof(segment_buffer)+sizeof(st_block_buffer)); }
+  #endif
+#endif
@@ -26,6 +26,25 @@
   #define SEGMENT_BUFFER_SIZE 10
 #endif
 
+#ifdef STEPPER_STEP_PATTERNS
+  #ifndef STEP_PATTERN_BUFFER_SIZE
+    #define STEP_PATTERN_BUFFER_SIZE 1024
+  #endif
+
+  // Highest ISR tick rate the pattern buffer is sized for. The maximum step rate, but at least the
+  // 16kHz that AMASS overdrives slower step rates to.
+  #ifdef MAX_STEP_RATE_HZ
+    #define STEP_PATTERN_MAX_STEP_RATE MAX_STEP_RATE_HZ
+  #else
+    #define STEP_PATTERN_MAX_STEP_RATE 30000 // Rated maximum step rate of Grbl
+  #endif
+  #if defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING) && (STEP_PATTERN_MAX_STEP_RATE < 16000)
+    #define STEP_PATTERN_MAX_TICK_RATE 16000
+  #else
+    #define STEP_PATTERN_MAX_TICK_RATE STEP_PATTERN_MAX_STEP_RATE
+  #endif
+#endif
+
 // Initialize and setup the stepper motor subsystem
 void stepper_init();
 
@@ -56,4 +75,41 @@ void st_update_plan_block_parameters();
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+#ifdef STEPPER_DEFERRED_POSITION
+  // Copies the real-time machine position in steps, including the steps of the executing segment.
+  void st_get_position(int32_t *position);
+#endif
+
+#ifdef REPORT_FIELD_SEGMENT_BUFFER_STATE
+  // Starts new per-job segment buffer statistics. Called when a cycle starts from IDLE.
+  void st_segment_buffer_stats_restart();
+
+  // Returns the lowest segment buffer fill seen in this job while planner blocks were queued.
+  uint8_t st_get_segment_buffer_min();
+
+  // Returns the number of segment buffer underruns in this job while planner blocks were queued.
+  uint16_t st_get_segment_buffer_underruns();
+#endif
+
+#ifdef ENABLE_SRAM_REPORT
+  // Returns the SRAM used by the segment buffer and the stepper block data, in bytes.
+  uint16_t st_get_buffer_footprint();
+#endif
+
+#ifdef DEBUG_STEPPER_ISR_PROFILE
+  // Stepper Driver Interrupt execution time statistics in CPU cycles.
+  #define ISR_PROFILE_BRESENHAM    0 // Ticks that only trace the Bresenham line
+  #define ISR_PROFILE_SEGMENT_LOAD 1 // Ticks that also load a new step segment
+  #define ISR_PROFILE_COUNT        2
+  typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint32_t count;
+  } st_isr_profile_t;
+
+  // Copies the ISR statistics into profile[ISR_PROFILE_COUNT] and restarts them.
+  void st_isr_profile_read(st_isr_profile_t *profile);
+#endif
+
 #endif
@@ -121,6 +121,33 @@ uint8_t system_execute_line(char *line)
       if(line[2] != '=') { return(STATUS_INVALID_STATEMENT); }
       return(gc_execute_line(line)); // NOTE: $J= is ignored inside g-code parser and used to detect jog motions.
       break;
+    #ifdef ENABLE_MAIN_LOOP_PROFILE
+      case 'L' : // Print or clear main loop latency histograms [ANY STATE]
+        if (line[2] == 0) { report_latency_histograms(); }
+        else if ((line[2] == 'R') && (line[3] == 0)) { latency_reset(); }
+        else { return(STATUS_INVALID_STATEMENT); }
+        break;
+    #endif
+    #ifdef ENABLE_EVENT_TRACE
+      case 'T' : // Dump and clear event trace [ANY STATE]
+        if (line[2] != 0) { return(STATUS_INVALID_STATEMENT); }
+        report_event_trace();
+        break;
+    #endif
+    #ifdef ENABLE_BLOCK_TIMING
+      case 'B' : // Print block timing, or start or stop streaming it [ANY STATE]
+        if (line[2] == 0) { report_block_timing(); }
+        else if ((line[2] == '=') && ((line[3] == '0') || (line[3] == '1')) && (line[4] == 0)) {
+          block_timing_set_streaming(line[3] == '1');
+        } else { return(STATUS_INVALID_STATEMENT); }
+        break;
+    #endif
+    #ifdef ENABLE_SRAM_REPORT
+      case 'M' : // Print SRAM usage [ANY STATE]
+        if (line[2] != 0) { return(STATUS_INVALID_STATEMENT); }
+        report_sram_usage();
+        break;
+    #endif
     case '$': case 'G': case 'C': case 'X':
       if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
       switch( line[1] ) {
@@ -283,14 +310,14 @@ float system_convert_axis_steps_to_mpos(int32_t *steps, uint8_t idx)
   float pos;
   #ifdef COREXY
     if (idx==X_AXIS) {
-      pos = (float)system_convert_corexy_to_x_axis_steps(steps) / settings.steps_per_mm[idx];
+      pos = (float)system_convert_corexy_to_x_axis_steps(steps)*settings_derived.mm_per_step[idx];
     } else if (idx==Y_AXIS) {
-      pos = (float)system_convert_corexy_to_y_axis_steps(steps) / settings.steps_per_mm[idx];
+      pos = (float)system_convert_corexy_to_y_axis_steps(steps)*settings_derived.mm_per_step[idx];
     } else {
-      pos = steps[idx]/settings.steps_per_mm[idx];
+      pos = steps[idx]*settings_derived.mm_per_step[idx];
     }
   #else
-    pos = steps[idx]/settings.steps_per_mm[idx];
+    pos = steps[idx]*settings_derived.mm_per_step[idx];
   #endif
   return(pos);
 }
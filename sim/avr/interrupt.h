@@ -0,0 +1,33 @@
+/*
+  interrupt.h - AVR interrupt stand-ins for the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_avr_interrupt_h
+#define sim_avr_interrupt_h
+
+// Interrupt service routines become ordinary functions named after their vector. The simulator
+// calls them directly when the modeled peripheral raises its flag and SREG_I is set.
+#define ISR(vector, ...) void vector(void)
+
+// Global interrupt enable and disable. Both are synchronization points, so any interrupt that
+// became pending while disabled is serviced as soon as sei() is executed.
+void sim_sei(void);
+void sim_cli(void);
+#define sei() sim_sei()
+#define cli() sim_cli()
+
+#endif
@@ -0,0 +1,247 @@
+/*
+  io.h - ATmega2560 register stand-ins for the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Every I/O register used by Grbl is a plain memory variable, so the firmware compiles unchanged
+// and even takes register addresses (see limits.c). The simulator in simulator.c watches these
+// variables at each synchronization point and models the timers, UART, and EEPROM around them.
+// Bit positions match the ATmega2560 datasheet.
+
+#ifndef sim_avr_io_h
+#define sim_avr_io_h
+
+#include <stdint.h>
+
+#ifdef SIM_DEFINE_REGISTERS
+  #define SIM_REG8(name)  volatile uint8_t name
+  #define SIM_REG16(name) volatile uint16_t name
+#else
+  #define SIM_REG8(name)  extern volatile uint8_t name
+  #define SIM_REG16(name) extern volatile uint16_t name
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+// Status register. Bit 7 is the global interrupt enable, driven by sei() and cli().
+SIM_REG8(SREG);
+#define SREG_I 7
+
+// General purpose I/O ports. The simulator mirrors PORTx into PINx for pins not driven externally.
+SIM_REG8(PORTA); SIM_REG8(DDRA); SIM_REG8(PINA);
+SIM_REG8(PORTB); SIM_REG8(DDRB); SIM_REG8(PINB);
+SIM_REG8(PORTC); SIM_REG8(DDRC); SIM_REG8(PINC);
+SIM_REG8(PORTD); SIM_REG8(DDRD); SIM_REG8(PIND);
+SIM_REG8(PORTE); SIM_REG8(DDRE); SIM_REG8(PINE);
+SIM_REG8(PORTF); SIM_REG8(DDRF); SIM_REG8(PINF);
+SIM_REG8(PORTG); SIM_REG8(DDRG); SIM_REG8(PING);
+SIM_REG8(PORTH); SIM_REG8(DDRH); SIM_REG8(PINH);
+SIM_REG8(PORTJ); SIM_REG8(DDRJ); SIM_REG8(PINJ);
+SIM_REG8(PORTK); SIM_REG8(DDRK); SIM_REG8(PINK);
+SIM_REG8(PORTL); SIM_REG8(DDRL); SIM_REG8(PINL);
+
+// Timer/Counter0 (8-bit)
+SIM_REG8(TCCR0A); SIM_REG8(TCCR0B); SIM_REG8(TCNT0); SIM_REG8(OCR0A); SIM_REG8(OCR0B);
+SIM_REG8(TIMSK0); SIM_REG8(TIFR0);
+#define WGM00 0
+#define WGM01 1
+#define COM0B0 4
+#define COM0B1 5
+#define COM0A0 6
+#define COM0A1 7
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define WGM02 3
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOV0 0
+#define OCF0A 1
+#define OCF0B 2
+
+// Timer/Counter1 (16-bit)
+SIM_REG8(TCCR1A); SIM_REG8(TCCR1B); SIM_REG8(TCCR1C); SIM_REG16(TCNT1);
+SIM_REG16(OCR1A); SIM_REG16(OCR1B); SIM_REG16(OCR1C); SIM_REG16(ICR1);
+SIM_REG8(TIMSK1); SIM_REG8(TIFR1);
+#define WGM10 0
+#define WGM11 1
+#define COM1C0 2
+#define COM1C1 3
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define OCIE1C 3
+#define TOV1 0
+#define OCF1A 1
+#define OCF1B 2
+#define OCF1C 3
+
+// Timer/Counter2 (8-bit)
+SIM_REG8(TCCR2A); SIM_REG8(TCCR2B); SIM_REG8(TCNT2); SIM_REG8(OCR2A); SIM_REG8(OCR2B);
+SIM_REG8(TIMSK2); SIM_REG8(TIFR2);
+#define WGM20 0
+#define WGM21 1
+#define COM2B0 4
+#define COM2B1 5
+#define COM2A0 6
+#define COM2A1 7
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define WGM22 3
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+
+// Timer/Counter3, 4 and 5 (16-bit)
+SIM_REG8(TCCR3A); SIM_REG8(TCCR3B); SIM_REG8(TCCR3C); SIM_REG16(TCNT3);
+SIM_REG16(OCR3A); SIM_REG16(OCR3B); SIM_REG16(OCR3C); SIM_REG16(ICR3);
+SIM_REG8(TIMSK3); SIM_REG8(TIFR3);
+SIM_REG8(TCCR4A); SIM_REG8(TCCR4B); SIM_REG8(TCCR4C); SIM_REG16(TCNT4);
+SIM_REG16(OCR4A); SIM_REG16(OCR4B); SIM_REG16(OCR4C); SIM_REG16(ICR4);
+SIM_REG8(TIMSK4); SIM_REG8(TIFR4);
+SIM_REG8(TCCR5B); SIM_REG16(TCNT5);
+SIM_REG16(OCR5A); SIM_REG16(OCR5B); SIM_REG16(OCR5C); SIM_REG16(ICR5);
+SIM_REG8(TIMSK5); SIM_REG8(TIFR5);
+// The Timer5 output compare units drive the OC5 pins. A force output compare strobe (FOC5x) in
+// TCCR5C acts with the compare output mode in TCCR5A at the time of the strobe, so both registers
+// are routed through the simulator, which applies a pending strobe before either is accessed again.
+volatile uint8_t *sim_timer5_control_register(uint8_t reg);
+#define TCCR5A (*sim_timer5_control_register(0))
+#define TCCR5C (*sim_timer5_control_register(2))
+#define WGM30 0
+#define WGM31 1
+#define COM3C1 3
+#define COM3B1 5
+#define COM3A1 7
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define WGM32 3
+#define WGM33 4
+#define TOIE3 0
+#define TOV3 0
+#define OCIE3A 1
+#define WGM40 0
+#define WGM41 1
+#define COM4C0 2
+#define COM4C1 3
+#define COM4B0 4
+#define COM4B1 5
+#define COM4A0 6
+#define COM4A1 7
+#define CS40 0
+#define CS41 1
+#define CS42 2
+#define WGM42 3
+#define WGM43 4
+#define TOIE4 0
+#define OCIE4A 1
+#define WGM50 0
+#define WGM51 1
+#define CS50 0
+#define CS51 1
+#define CS52 2
+#define WGM52 3
+#define WGM53 4
+#define TOIE5 0
+#define TOV5 0
+#define OCIE5A 1
+#define COM5C0 2
+#define COM5C1 3
+#define COM5B0 4
+#define COM5B1 5
+#define COM5A0 6
+#define COM5A1 7
+#define FOC5C 5
+#define FOC5B 6
+#define FOC5A 7
+
+// USART0
+SIM_REG8(UCSR0A); SIM_REG8(UCSR0B); SIM_REG8(UCSR0C); SIM_REG8(UDR0);
+SIM_REG8(UBRR0H); SIM_REG8(UBRR0L);
+#define MPCM0 0
+#define U2X0 1
+#define UPE0 2
+#define DOR0 3
+#define FE0 4
+#define UDRE0 5
+#define TXC0 6
+#define RXC0 7
+#define TXB80 0
+#define RXB80 1
+#define UCSZ02 2
+#define TXEN0 3
+#define RXEN0 4
+#define UDRIE0 5
+#define TXCIE0 6
+#define RXCIE0 7
+#define UCPOL0 0
+#define UCSZ00 1
+#define UCSZ01 2
+#define USBS0 3
+
+// EEPROM. The data register is routed through the simulator so a read strobe (EERE) returns
+// the addressed byte immediately, as on hardware.
+SIM_REG8(EECR); SIM_REG16(EEAR);
+volatile uint8_t *sim_eeprom_data_register(void);
+#define EEDR (*sim_eeprom_data_register())
+#define EERE 0
+#define EEPE 1
+#define EEMPE 2
+#define EERIE 3
+#define E2END 0x0FFF
+
+// Pin change and external interrupts
+SIM_REG8(PCICR); SIM_REG8(PCIFR); SIM_REG8(PCMSK0); SIM_REG8(PCMSK1); SIM_REG8(PCMSK2);
+SIM_REG8(EICRA); SIM_REG8(EICRB); SIM_REG8(EIMSK); SIM_REG8(EIFR);
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define INT0 0
+#define INT1 1
+#define INT2 2
+#define INT3 3
+#define INT4 4
+#define INT5 5
+
+// Watchdog and MCU status
+SIM_REG8(WDTCSR); SIM_REG8(MCUSR); SIM_REG8(SPMCSR);
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE 3
+#define WDCE 4
+#define WDP3 5
+#define WDIE 6
+#define WDIF 7
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+#define JTRF 4
+
+#endif
@@ -0,0 +1,32 @@
+/*
+  pgmspace.h - AVR program memory stand-ins for the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_avr_pgmspace_h
+#define sim_avr_pgmspace_h
+
+#include <stdint.h>
+#include <string.h>
+
+// The host has a single address space, so flash-resident data is ordinary const data.
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte_near(addr) (*(const uint8_t *)(addr))
+#define pgm_read_byte(addr) pgm_read_byte_near(addr)
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+
+#endif
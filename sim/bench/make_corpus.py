@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+"""\
+Generates the planner benchmark corpus
+
+Writes three g-code programs with the character of real CAM output into
+the given directory. Everything is computed from fixed parameters, so
+the corpus is identical on every run and every machine.
+
+  surfacing.nc  3D raster finishing pass over a wavy surface, 0.05mm
+                segments with Z changing on every line.
+  adaptive.nc   Trochoidal (adaptive) clearing of a slot, linearized
+                into 0.05mm chords with continuously turning direction.
+  arcs.nc       Dense G2/G3 arcs and helices of 0.5-3mm radius, which
+                Grbl splits into short line segments itself.
+
+Usage: make_corpus.py <output directory>
+"""
+
+import math
+import os
+import sys
+
+SEGMENT = 0.05 # CAM segment length in mm
+
+
+def header(f, feed):
+  f.write("G21G90G94G17\nG0Z2.000\nG0X0.000Y0.000\nG1Z0.000F%d\n" % feed)
+
+
+def footer(f):
+  f.write("G0Z2.000\nM2\n")
+
+
+def surfacing(f):
+  header(f, 1000)
+  width, height, stepover = 20.0, 10.0, 0.5
+  n = int(round(width/SEGMENT))
+  rows = int(round(height/stepover))
+  for row in range(rows+1):
+    y = row*stepover
+    for i in range(n+1):
+      x = i*SEGMENT if row % 2 == 0 else width - i*SEGMENT
+      z = 0.5*math.sin(x/3.0)*math.cos(y/4.0) - 1.0
+      f.write("X%.3fY%.3fZ%.3f\n" % (x, y, z))
+  footer(f)
+
+
+def adaptive(f):
+  header(f, 1500)
+  radius, advance, turns = 2.0, 0.5, 30 # Trochoid radius and slot advance per turn in mm
+  dt = SEGMENT/radius
+  n = int(round(2.0*math.pi*turns/dt))
+  for i in range(1, n+1):
+    t = i*dt
+    x = advance*t/(2.0*math.pi) + radius*(1.0 - math.cos(t))
+    y = radius*math.sin(t)
+    f.write("X%.3fY%.3f\n" % (x, y))
+  footer(f)
+
+
+def arcs(f):
+  header(f, 800)
+  x, z = 0.0, 0.0
+  for i in range(400):
+    r = 0.5 + 2.5*((i*7) % 11)/10.0 # Radius cycles through 0.5-3mm
+    cmd = "G2" if i % 2 == 0 else "G3"
+    x += 2.0*r
+    if i % 5 == 4: # Every fifth arc is a helix
+      z = -0.2 if z == 0.0 else 0.0
+      f.write("%sX%.3fY0.000Z%.3fI%.3fJ0.000\n" % (cmd, x, z, r))
+    else:
+      f.write("%sX%.3fY0.000I%.3fJ0.000\n" % (cmd, x, r))
+  footer(f)
+
+
+def main():
+  if len(sys.argv) != 2:
+    sys.stderr.write(__doc__)
+    sys.exit(1)
+  out = sys.argv[1]
+  if not os.path.isdir(out):
+    os.makedirs(out)
+  for name, generate in (("surfacing.nc", surfacing), ("adaptive.nc", adaptive), ("arcs.nc", arcs)):
+    with open(os.path.join(out, name), "w") as f:
+      generate(f)
+
+
+if __name__ == "__main__":
+  main()
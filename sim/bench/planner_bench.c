@@ -0,0 +1,309 @@
+/*
+  planner_bench.c - planner throughput benchmark on the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Feeds g-code files through gc_execute_line() -> mc_line()/mc_arc() -> plan_buffer_line() and
+// measures how fast the main program can plan them. The stepper is replaced by an infinitely
+// fast consumer: whenever mc_line() finds the planner buffer full, the oldest block is retired,
+// and buffer synchronizations retire them all. Every plan_buffer_line() call therefore runs
+// against a full look-ahead buffer, the steady state of a long CAM job.
+//
+// Times are host times and only meaningful relative to another build on the same machine. The
+// blocks visited per planner_recalculate() call do not depend on the host and track the AVR cost.
+// With PLANNER_RECALCULATE_LIMIT, the recalculations resumed while mc_line() waits on the full
+// buffer are reported apart from those made by plan_buffer_line(). With PLANNER_COALESCE_TOLERANCE,
+// the lines merged into the last block, instead of queueing a block of their own, are counted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "grbl.h"
+#include "simulator.h"
+
+#define BENCH_MAX_LINES 200000
+
+#ifdef PLANNER_RECALCULATE_LIMIT
+  #define BENCH_RECALCULATE_LIMIT PLANNER_RECALCULATE_LIMIT
+#else
+  #define BENCH_RECALCULATE_LIMIT 0
+#endif
+
+extern void *const bench_planner_recalculate;
+extern void *const bench_plan_prev_block_index;
+extern void *const bench_plan_next_block_index;
+extern plan_index_t *const bench_block_buffer_head;
+#ifdef PLANNER_COALESCE_TOLERANCE
+  extern void *const bench_plan_coalesce_line;
+#endif
+
+typedef struct {
+  uint32_t lines;
+  uint32_t errors;
+  uint32_t blocks;           // plan_buffer_line() calls
+  uint32_t merged;           // Calls merged into the last block, instead of queueing a new one
+  uint64_t total_ns;         // All of gc_execute_line(), parser included
+  uint64_t buffer_line_ns;   // Inside plan_buffer_line(), recalculation included
+  uint64_t buffer_line_max_ns;
+  uint64_t buffer_line_p999_ns;   // 99.9th percentile, less sensitive to host interruptions
+  uint32_t recalc_count;
+  uint64_t recalc_ns;
+  uint64_t recalc_max_ns;
+  uint64_t recalc_visits;    // Blocks stepped over by the reverse and forward passes
+  uint32_t recalc_max_visits;
+  uint32_t resume_count;     // Recalculations outside plan_buffer_line() that visited any blocks
+  uint64_t resume_ns;
+  uint64_t resume_visits;
+  uint32_t resume_max_visits;
+} bench_t;
+
+static bench_t bench;
+static uint64_t buffer_line_start, recalc_start;
+static uint32_t *buffer_line_times, buffer_line_times_size;
+static uint32_t visits;
+static uint8_t in_recalc, in_buffer_line, in_coalesce;
+static plan_index_t buffer_line_head;
+
+
+static uint64_t now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return((uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec);
+}
+
+
+static void bench_on_call(void *fn, uint8_t enter)
+{
+  if (fn == bench_planner_recalculate) {
+    if (enter) {
+      visits = 0;
+      in_recalc = true;
+      recalc_start = now_ns();
+    } else {
+      uint64_t ns = now_ns() - recalc_start;
+      in_recalc = false;
+      if (!in_buffer_line) {
+        if (visits) {
+          bench.resume_count++;
+          bench.resume_ns += ns;
+          bench.resume_visits += visits;
+          if (visits > bench.resume_max_visits) { bench.resume_max_visits = visits; }
+        }
+        return;
+      }
+      bench.recalc_count++;
+      bench.recalc_ns += ns;
+      if (ns > bench.recalc_max_ns) { bench.recalc_max_ns = ns; }
+      bench.recalc_visits += visits;
+      if (visits > bench.recalc_max_visits) { bench.recalc_max_visits = visits; }
+    }
+  } else if (fn == (void *)plan_buffer_line) {
+    in_buffer_line = enter;
+    if (enter) {
+      in_coalesce = false;
+      buffer_line_head = *bench_block_buffer_head;
+      buffer_line_start = now_ns();
+    } else {
+      uint64_t ns = now_ns() - buffer_line_start;
+      if (in_coalesce && (*bench_block_buffer_head == buffer_line_head)) { bench.merged++; }
+      if (bench.blocks == buffer_line_times_size) {
+        buffer_line_times_size = buffer_line_times_size ? 2*buffer_line_times_size : 65536;
+        buffer_line_times = realloc(buffer_line_times, buffer_line_times_size*sizeof(uint32_t));
+        if (buffer_line_times == NULL) { perror("bench"); exit(1); }
+      }
+      buffer_line_times[bench.blocks] = (ns > UINT32_MAX) ? UINT32_MAX : ns;
+      bench.blocks++;
+      bench.buffer_line_ns += ns;
+      if (ns > bench.buffer_line_max_ns) { bench.buffer_line_max_ns = ns; }
+    }
+  #ifdef PLANNER_COALESCE_TOLERANCE
+    } else if (fn == bench_plan_coalesce_line) {
+      in_coalesce = true;
+  #endif
+  } else if (in_recalc && enter) {
+    if ((fn == bench_plan_prev_block_index) || (fn == bench_plan_next_block_index)) { visits++; }
+  }
+}
+
+
+// Stand-ins for the stepper, linked in with --wrap. See the top of this file.
+void __wrap_protocol_auto_cycle_start() { plan_discard_current_block(); }
+
+void __wrap_protocol_buffer_synchronize()
+{
+  while (plan_get_current_block() != NULL) { plan_discard_current_block(); }
+}
+
+
+// Reads a g-code file into memory, formatted as protocol_main_loop() would hand it to the parser.
+static char **load_lines(const char *filename, uint32_t *count)
+{
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) { return(NULL); }
+  char **lines = malloc(BENCH_MAX_LINES*sizeof(char *));
+  char buf[256], line[LINE_BUFFER_SIZE];
+  *count = 0;
+  while ((*count < BENCH_MAX_LINES) && fgets(buf, sizeof(buf), fp)) {
+    uint16_t n = 0;
+    char *c;
+    for (c = buf; *c && (*c != '\n') && (*c != '\r'); c++) {
+      if ((*c == '(') || (*c == ';')) { break; } // Comments are stripped by the protocol.
+      if (*c <= ' ') { continue; }
+      if (n < LINE_BUFFER_SIZE-1) { line[n++] = (*c >= 'a' && *c <= 'z') ? *c-'a'+'A' : *c; }
+    }
+    if (n == 0) { continue; }
+    line[n] = 0;
+    lines[(*count)++] = strdup(line);
+  }
+  fclose(fp);
+  return(lines);
+}
+
+
+static int compare_times(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return((x > y) - (x < y));
+}
+
+
+static void run_file(char **lines, uint32_t count)
+{
+  uint32_t i;
+  memset(&bench, 0, sizeof(bench));
+  plan_reset();
+  gc_init();
+  memset(sys_position, 0, sizeof(sys_position));
+  plan_sync_position();
+  gc_sync_position();
+
+  uint64_t start = now_ns();
+  for (i = 0; i < count; i++) {
+    if (gc_execute_line(lines[i]) != STATUS_OK) {
+      if (!bench.errors) { fprintf(stderr, "bench: error on line %lu: %s\n", (unsigned long)i+1, lines[i]); }
+      bench.errors++;
+    }
+  }
+  bench.total_ns = now_ns() - start;
+  bench.lines = count;
+  if (bench.blocks) {
+    qsort(buffer_line_times, bench.blocks, sizeof(uint32_t), compare_times);
+    bench.buffer_line_p999_ns = buffer_line_times[(uint32_t)(0.999*(bench.blocks-1))];
+  }
+}
+
+
+static void print_result(const char *filename, uint8_t summary)
+{
+  const char *name = strrchr(filename, '/');
+  name = name ? name+1 : filename;
+  double seconds = 1e-9*bench.total_ns;
+  if (summary) {
+    printf("%-14s %6d %5d %10.0f %10lu %8.1f %6lu\n", name, BLOCK_BUFFER_SIZE, BENCH_RECALCULATE_LIMIT,
+      bench.blocks ? (double)bench.buffer_line_ns/bench.blocks : 0.0, (unsigned long)bench.buffer_line_p999_ns,
+      bench.recalc_count ? (double)bench.recalc_visits/bench.recalc_count : 0.0,
+      (unsigned long)bench.recalc_max_visits);
+    return;
+  }
+  printf("%s: %lu lines, %lu blocks, %.3f s", name, (unsigned long)bench.lines,
+    (unsigned long)bench.blocks, seconds);
+  if (bench.merged) { printf(" (%lu merged)", (unsigned long)bench.merged); }
+  if (bench.errors) { printf(", %lu errors", (unsigned long)bench.errors); }
+  printf("\n  throughput           %.0f blocks/s, %.0f lines/s\n",
+    bench.blocks/seconds, bench.lines/seconds);
+  if (bench.blocks) {
+    printf("  plan_buffer_line     avg %.0f ns/block (%.0f%% of total), 99.9%% within %lu ns, max %lu ns\n",
+      (double)bench.buffer_line_ns/bench.blocks, 100.0*bench.buffer_line_ns/bench.total_ns,
+      (unsigned long)bench.buffer_line_p999_ns, (unsigned long)bench.buffer_line_max_ns);
+  }
+  if (bench.recalc_count) {
+    printf("  planner_recalculate  avg %.0f ns, max %lu ns, avg %.1f blocks, max %lu blocks\n",
+      (double)bench.recalc_ns/bench.recalc_count, (unsigned long)bench.recalc_max_ns,
+      (double)bench.recalc_visits/bench.recalc_count, (unsigned long)bench.recalc_max_visits);
+  }
+  if (bench.resume_count) {
+    printf("  resumed when waiting %lu calls, avg %.0f ns, avg %.1f blocks, max %lu blocks\n",
+      (unsigned long)bench.resume_count, (double)bench.resume_ns/bench.resume_count,
+      (double)bench.resume_visits/bench.resume_count, (unsigned long)bench.resume_max_visits);
+  }
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [-r repeats] [-s] file.nc...\n"
+    "Plans each g-code file with the default settings and reports planner throughput.\n"
+    "  -r repeats  Run each file this many times and report the fastest run (default 5)\n"
+    "  -s          Print one summary line per file, without a header\n",
+    name);
+}
+
+
+int main(int argc, char *argv[])
+{
+  int opt, i, repeats = 5;
+  uint8_t summary = false;
+  while ((opt = getopt(argc, argv, "r:sh")) != -1) {
+    switch (opt) {
+      case 'r': repeats = atoi(optarg); break;
+      case 's': summary = true; break;
+      default: usage(argv[0]); return(opt == 'h' ? 0 : 1);
+    }
+  }
+  if ((optind >= argc) || (repeats < 1)) { usage(argv[0]); return(1); }
+
+  // Bring Grbl up as main() would, from an erased EEPROM so the defaults are restored.
+  sim_eeprom_load("/dev/null");
+  sim_init();
+  serial_init();
+  settings_init();
+  stepper_init();
+  system_init();
+  sei();
+  memset(&sys, 0, sizeof(system_t));
+  sys.state = STATE_IDLE;
+  sys.f_override = DEFAULT_FEED_OVERRIDE;
+  sys.r_override = DEFAULT_RAPID_OVERRIDE;
+  sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE;
+
+  // From here on only the main program runs, at host speed, with the profiler attached.
+  sim.passive = true;
+  sim.on_call = bench_on_call;
+
+  if (!summary) {
+    printf("Planner benchmark: BLOCK_BUFFER_SIZE %d", BLOCK_BUFFER_SIZE);
+    if (BENCH_RECALCULATE_LIMIT) { printf(", PLANNER_RECALCULATE_LIMIT %d", BENCH_RECALCULATE_LIMIT); }
+    printf(", best of %d runs\n", repeats);
+  }
+  for (i = optind; i < argc; i++) {
+    uint32_t count;
+    char **lines = load_lines(argv[i], &count);
+    if (lines == NULL) { perror(argv[i]); return(1); }
+    bench_t best;
+    int r;
+    for (r = 0; r < repeats; r++) {
+      run_file(lines, count);
+      if ((r == 0) || (bench.total_ns < best.total_ns)) { best = bench; }
+    }
+    bench = best;
+    print_result(argv[i], summary);
+  }
+  return(0);
+}
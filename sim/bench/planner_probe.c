@@ -0,0 +1,29 @@
+/*
+  planner_probe.c - Grbl's planner, built so the benchmark can profile its static routines
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// The planner source is compiled here, in place of planner.o, so that the addresses of its
+// static functions can be handed to the profiler. The planner code itself is unchanged.
+#include "planner.c"
+
+void *const bench_planner_recalculate = (void *)planner_recalculate;
+void *const bench_plan_prev_block_index = (void *)plan_prev_block_index;
+void *const bench_plan_next_block_index = (void *)plan_next_block_index;
+plan_index_t *const bench_block_buffer_head = &block_buffer_head;
+#ifdef PLANNER_COALESCE_TOLERANCE
+  void *const bench_plan_coalesce_line = (void *)plan_coalesce_line;
+#endif
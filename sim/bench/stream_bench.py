@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""Streaming benchmark: a g-code sender on a pseudo-terminal against the Grbl host simulator.
+
+Starts 'grbl_sim -p' at each baud rate, so Grbl's serial ISRs run behind a modeled UART in real
+time, and streams g-code to it as doc/script/stream.py would: one line at a time, waiting for each
+'ok' (simple), or keeping Grbl's RX buffer full by counting characters (counting). Status reports
+are polled throughout the job. For each run it reports:
+
+  lines/s      Lines acknowledged per second, from the first line sent to the last 'ok'.
+  ok latency   Time from sending a line to receiving its 'ok'. In counting mode this includes
+               the time the line waited in Grbl's RX buffer.
+  starved      Share of status reports with the planner not full and the RX buffer empty, i.e.
+               Grbl was waiting on the sender. Idle gaps are the unbroken runs of such reports.
+  planner      Blocks in the planner buffer: average and minimum over the job, and the average
+               of each tenth of the job.
+  buffered     Execution time queued in the planner buffer, when Grbl reports it (Bt:), with the
+               same statistics.
+  overruns     Bytes lost to a full RX buffer, as counted by the simulator.
+
+Times are wall clock times. The simulator holds its virtual time to the wall clock and reports
+how far it ever fell behind. Results are only meaningful while that lag stays small.
+
+The RX buffer size used for character counting is read from Grbl's idle status report, so the
+simulator may be built with another RX_BUFFER_SIZE, e.g.
+  make -C sim SIM_CFLAGS=-DRX_BUFFER_SIZE=128
+"""
+
+import argparse
+import os
+import re
+import select
+import subprocess
+import sys
+import tempfile
+import termios
+import time
+import tty
+
+STATUS_RE = re.compile(rb'<(\w+)[^>]*\|Bf:(\d+),(\d+)')
+BUFFER_TIME_RE = re.compile(rb'\|Bt:(\d+)')
+OVERRUN_RE = re.compile(rb'sim: (\d+) bytes received while the RX buffer was full')
+LAG_RE = re.compile(rb'fell behind real time by up to ([\d.]+) ms')
+
+
+class Link(object):
+    """The sender's end of the pseudo-terminal, split into lines."""
+
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd, termios.TCSANOW)
+        self.partial = b''
+
+    def write(self, data):
+        while data:
+            data = data[os.write(self.fd, data):]
+
+    def read_lines(self, timeout):
+        """Returns the lines completed within timeout seconds, each with its arrival time."""
+        r, _, _ = select.select([self.fd], [], [], max(timeout, 0))
+        if not r:
+            return []
+        self.partial += os.read(self.fd, 4096)
+        now = time.monotonic()
+        *done, self.partial = self.partial.split(b'\n')
+        return [(now, l.strip()) for l in done if l.strip()]
+
+    def close(self):
+        os.close(self.fd)
+
+
+def load_lines(filenames, limit):
+    """Reads g-code lines with comments and spaces removed, as stream.py sends them."""
+    lines = []
+    for filename in filenames:
+        with open(filename) as f:
+            for line in f:
+                line = re.sub(r'\(.*?\)|;.*', '', line).strip().replace(' ', '')
+                if line:
+                    lines.append(line)
+                if len(lines) >= limit:
+                    return lines
+    return lines
+
+
+def run(sim, eeprom, baud, mode, lines, interval):
+    proc = subprocess.Popen([sim, '-p', '-b', str(baud), '-e', eeprom], stderr=subprocess.PIPE)
+    link = Link(proc.stderr.readline().split()[-1])
+
+    # Wait for the main loop. The idle report gives the empty planner and RX buffer sizes.
+    idle = None
+    while idle is None:
+        link.write(b'?')
+        for _, l in link.read_lines(0.1):
+            m = STATUS_RE.match(l)
+            if m and m.group(1) == b'Idle':
+                idle = (int(m.group(2)), int(m.group(3)))
+    planner_size, rx_size = idle
+
+    sent = acked = errors = 0
+    last_ok = 0
+    in_rx = []       # Lengths of the unacknowledged lines
+    send_time = []
+    latency = []
+    status = []      # (time, planner blocks used, starved, buffered ms or None)
+    next_poll = time.monotonic()
+    while True:
+        if sent < len(lines):
+            data = (lines[sent] + '\n').encode()
+            if mode == 'simple':
+                ready = (acked == sent)
+            else:
+                ready = (sum(in_rx) + len(data) <= rx_size - 1)
+            if ready:
+                link.write(data)
+                send_time.append(time.monotonic())
+                in_rx.append(len(data))
+                sent += 1
+                continue
+        now = time.monotonic()
+        if now >= next_poll:
+            link.write(b'?')
+            next_poll = now + interval
+        done = False
+        for t, l in link.read_lines(min(next_poll - now, 0.002)):
+            if l.startswith(b'ok') or l.startswith(b'error'):
+                errors += l.startswith(b'error')
+                latency.append(t - send_time[acked])
+                last_ok = t
+                in_rx.pop(0)
+                acked += 1
+                continue
+            m = STATUS_RE.match(l)
+            if not m:
+                continue
+            if acked < len(lines):
+                used = planner_size - int(m.group(2))
+                bt = BUFFER_TIME_RE.search(l)
+                status.append((t, used, used < planner_size and int(m.group(3)) == rx_size,
+                               int(bt.group(1)) if bt else None))
+            elif m.group(1) == b'Idle':
+                done = True
+        if done:
+            break
+    link.close()
+    summary = proc.communicate()[1]
+
+    m = OVERRUN_RE.search(summary)
+    lag = LAG_RE.search(summary)
+    return dict(lines=acked, errors=errors, latency=sorted(latency), status=status,
+                elapsed=last_ok - send_time[0],
+                planner_size=planner_size, rx_size=rx_size,
+                overruns=int(m.group(1)) if m else 0, lag=float(lag.group(1)) if lag else 0.0)
+
+
+def idle_gaps(status):
+    """Returns the durations of the unbroken runs of starved status reports."""
+    gaps = []
+    begin = None
+    for t, _, starved, _ in status:
+        if starved and begin is None:
+            begin = t
+        elif not starved and begin is not None:
+            gaps.append(t - begin)
+            begin = None
+    return gaps
+
+
+def print_result(baud, mode, r):
+    lat = r['latency']
+    status = r['status']
+    fill = [used for _, used, _, _ in status]
+    buffered = [bt for _, _, _, bt in status if bt is not None]
+    gaps = idle_gaps(status)
+    starved = sum(1 for _, _, s, _ in status if s)
+    print('  %7d %-8s %7.0f lines/s  ok latency avg %.1f p99 %.1f max %.1f ms' % (
+        baud, mode, r['lines']/r['elapsed'], 1e3*sum(lat)/len(lat),
+        1e3*lat[int(0.99*(len(lat)-1))], 1e3*lat[-1]))
+    print('                   starved %4.1f%%, %d idle gaps, %.0f ms total, longest %.0f ms' % (
+        100.0*starved/max(len(status), 1), len(gaps), 1e3*sum(gaps), 1e3*max(gaps or [0])))
+    if fill:
+        tenths = [fill[i*len(fill)//10:(i+1)*len(fill)//10] or [0] for i in range(10)]
+        print('                   planner avg %.1f min %d of %d blocks, by tenth: %s' % (
+            float(sum(fill))/len(fill), min(fill), r['planner_size'],
+            ' '.join('%.0f' % (float(sum(t))/len(t)) for t in tenths)))
+    if buffered:
+        tenths = [buffered[i*len(buffered)//10:(i+1)*len(buffered)//10] or [0] for i in range(10)]
+        print('                   buffered avg %.0f min %d ms, by tenth: %s' % (
+            float(sum(buffered))/len(buffered), min(buffered),
+            ' '.join('%.0f' % (float(sum(t))/len(t)) for t in tenths)))
+    print('                   %d overruns, %d errors, simulator lag up to %.1f ms' % (
+        r['overruns'], r['errors'], r['lag']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Streams g-code to the Grbl host simulator over '
+                                     'a pseudo-terminal and measures the link.')
+    parser.add_argument('files', nargs='+', help='g-code files, streamed as one job')
+    parser.add_argument('--sim', default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        '..', 'grbl_sim'), help='simulator binary (default sim/grbl_sim)')
+    parser.add_argument('--baud', type=int, nargs='+', default=[115200, 230400, 1000000],
+                        help='baud rates to model (default 115200 230400 1000000)')
+    parser.add_argument('--mode', nargs='+', choices=['simple', 'counting'],
+                        default=['simple', 'counting'], help='streaming protocols (default both)')
+    parser.add_argument('--lines', type=int, default=2000,
+                        help='stream at most this many lines (default 2000)')
+    parser.add_argument('--interval', type=float, default=0.05,
+                        help='status report interval in seconds (default 0.05)')
+    parser.add_argument('--setup', default='', metavar='LINES',
+                        help="settings to apply before streaming, e.g. '$110=20000 $120=500'")
+    args = parser.parse_args()
+
+    lines = load_lines(args.files, args.lines)
+    with tempfile.NamedTemporaryFile(suffix='.eeprom') as eeprom:
+        # Restore the default settings once, with the buffer state in status reports ($10=3).
+        setup = ''.join(l + '\n' for l in ['$10=3'] + args.setup.split()).encode()
+        subprocess.run([args.sim, '-q', '-e', eeprom.name, '-o', os.devnull], input=setup, check=True)
+        print('Streaming benchmark: %d lines of %s' % (len(lines), ' '.join(
+            os.path.basename(f) for f in args.files)))
+        for baud in args.baud:
+            for mode in args.mode:
+                print_result(baud, mode, run(args.sim, eeprom.name, baud, mode, lines, args.interval))
+                sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
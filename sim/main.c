@@ -0,0 +1,214 @@
+/*
+  main.c - command line front end of the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE // posix_openpt() and friends
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "simulator.h"
+#include "step_trace.h"
+
+static FILE *input;
+static FILE *output;
+static const char *eeprom_file;
+static const char *trace_file;
+static int pending = SIM_RX_NONE;
+static uint8_t quiet;
+static uint8_t use_pty;
+static struct timespec host_start;
+
+// Pseudo-terminal mode. The host program opens the slave side like a serial port.
+static int pty_master = -1;
+static int pty_slave = -1; // Held open until the host connects, so its first open sees a raw terminal.
+static uint8_t pty_buffer[256];
+static int pty_head, pty_count;
+static uint8_t pty_closed;
+static uint64_t pty_next_read;
+
+
+static int input_poll(void)
+{
+  if (pending == SIM_RX_NONE) {
+    int c = getc(input);
+    pending = (c == EOF) ? SIM_RX_EOF : c;
+  }
+  return(pending);
+}
+
+
+static void input_consume(void) { pending = SIM_RX_NONE; }
+
+
+static void output_write(uint8_t data) { putc(data, output); }
+
+
+static int pty_poll(void)
+{
+  if (!pty_count && !pty_closed) {
+    // A UART cannot take bytes faster than its character time, so neither does the pty need polling.
+    if (sim.cycles < pty_next_read) { return(SIM_RX_NONE); }
+    pty_next_read = sim.cycles + sim_uart_char_cycles();
+    ssize_t n = read(pty_master, pty_buffer, sizeof(pty_buffer));
+    if (n > 0) {
+      pty_head = 0;
+      pty_count = n;
+      if (pty_slave >= 0) { close(pty_slave); pty_slave = -1; }
+    } else if ((n == 0) || ((errno != EAGAIN) && (errno != EINTR))) {
+      pty_closed = 1; // EIO once the host has closed its end.
+    }
+  }
+  if (pty_count) { return(pty_buffer[pty_head]); }
+  return(pty_closed ? SIM_RX_EOF : SIM_RX_NONE);
+}
+
+
+static void pty_consume(void)
+{
+  pty_head++;
+  pty_count--;
+}
+
+
+static void pty_write(uint8_t data)
+{
+  while (write(pty_master, &data, 1) != 1) {
+    if (errno == EIO) { return; } // Host is gone. Nobody to send to.
+    struct pollfd p = { pty_master, POLLOUT, 0 };
+    poll(&p, 1, -1);
+  }
+}
+
+
+static int pty_open()
+{
+  pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((pty_master < 0) || grantpt(pty_master) || unlockpt(pty_master)) { return(0); }
+  pty_slave = open(ptsname(pty_master), O_RDWR | O_NOCTTY);
+  if (pty_slave < 0) { return(0); }
+  struct termios tio;
+  tcgetattr(pty_slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(pty_slave, TCSANOW, &tio);
+  fcntl(pty_master, F_SETFL, fcntl(pty_master, F_GETFL) | O_NONBLOCK);
+  fprintf(stderr, "sim: pty %s\n", ptsname(pty_master));
+  return(1);
+}
+
+
+static double host_elapsed()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return((now.tv_sec - host_start.tv_sec) + 1e-9*(now.tv_nsec - host_start.tv_nsec));
+}
+
+
+static void finish(void)
+{
+  fflush(output);
+  if (eeprom_file && !sim_eeprom_save(eeprom_file)) {
+    fprintf(stderr, "sim: cannot write eeprom file %s\n", eeprom_file);
+  }
+  if (!step_trace_close()) { fprintf(stderr, "sim: cannot write step trace %s\n", trace_file); }
+  if (!quiet) { sim_report(stderr, host_elapsed()); }
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [options] [gcode_file]\n"
+    "Streams gcode_file (default stdin) into Grbl over the virtual UART and writes Grbl's\n"
+    "serial output to stdout. Exits once the job has been fully executed.\n"
+    "  -b baud     Model the UART at this baud rate instead of the programmed UBRR0\n"
+    "  -c cycles   CPU cycles charged per firmware function call (default %d)\n"
+    "  -e file     EEPROM image to load at start and save at exit\n"
+    "  -n          Disable flow control. Bytes arrive at line rate and may overrun Grbl\n"
+    "  -o file     Write serial output to file\n"
+    "  -p          Serve the virtual UART on a pseudo-terminal, in real time, instead of\n"
+    "              streaming gcode_file. The terminal's name is printed to stderr\n"
+    "  -q          Do not print the simulation summary\n"
+    "  -s file     Record step and direction pin edges to a binary trace file\n"
+    "  -t seconds  Stop after this much virtual time\n",
+    name, SIM_DEFAULT_CYCLES_PER_CALL);
+}
+
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  input = stdin;
+  output = stdout;
+  sim.rx_flow_control = 1;
+  while ((opt = getopt(argc, argv, "b:c:e:no:pqs:t:h")) != -1) {
+    switch (opt) {
+      case 'b': sim.baud_rate = strtoul(optarg, NULL, 10); break;
+      case 'c': sim.cycles_per_call = strtoul(optarg, NULL, 10); break;
+      case 'e': eeprom_file = optarg; break;
+      case 'n': sim.rx_flow_control = 0; break;
+      case 'o':
+        output = fopen(optarg, "wb");
+        if (output == NULL) { perror(optarg); return(1); }
+        break;
+      case 'p': use_pty = 1; break;
+      case 'q': quiet = 1; break;
+      case 's': trace_file = optarg; break;
+      case 't': sim.cycle_limit = (uint64_t)(strtod(optarg, NULL)*F_CPU); break;
+      default: usage(argv[0]); return(opt == 'h' ? 0 : 1);
+    }
+  }
+  if (optind < argc) {
+    input = fopen(argv[optind], "rb");
+    if (input == NULL) { perror(argv[optind]); return(1); }
+  }
+
+  if (eeprom_file) { sim_eeprom_load(eeprom_file); }
+  else { sim_eeprom_load("/dev/null"); } // Erased EEPROM. Grbl restores its defaults.
+
+  if (trace_file) {
+    FILE *fp = fopen(trace_file, "wb");
+    if (fp == NULL) { perror(trace_file); return(1); }
+    step_trace_open(fp);
+  }
+
+  if (use_pty) {
+    // Like a real serial link: no flow control, and the host's pace is set by the wall clock.
+    if (!pty_open()) { perror("sim: pty"); return(1); }
+    sim.rx_poll = pty_poll;
+    sim.rx_consume = pty_consume;
+    sim.tx_write = pty_write;
+    sim.rx_flow_control = 0;
+    sim.realtime = 1;
+  } else {
+    sim.rx_poll = input_poll;
+    sim.rx_consume = input_consume;
+    sim.tx_write = output_write;
+  }
+  sim.on_exit = finish;
+  sim_init();
+
+  clock_gettime(CLOCK_MONOTONIC, &host_start);
+  avr_main(); // Never returns. The simulator exits when the job is complete.
+  return(0);
+}
@@ -0,0 +1,630 @@
+/*
+  simulator.c - virtual-time ATmega2560 model that runs Grbl on a host computer
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* The firmware sources are compiled unchanged with -finstrument-functions, so every function
+   entry in Grbl calls __cyg_profile_func_enter() below. That call is the synchronization point
+   of the simulator: it inspects the register variables for anything the firmware has written
+   (timer reloads, prescalers, interrupt masks, EEPROM strobes), charges the cost of the call to
+   virtual time, and services every interrupt that has come due in between. Busy-wait delays,
+   sei() and cli() are synchronization points as well.
+
+   Timers are modeled from their registers, not from the firmware's intent: Timer1 runs in CTC
+   mode and matches every (OCR1A+1)*prescaler cycles from its last match, Timer0 overflows
+   (256-TCNT0)*prescaler cycles after it is started, and flags stay latched while the interrupt
+   is masked or SREG_I is clear. Interrupt service routines run in zero virtual time, so the
+   stepper ISR fires on the exact tick its segment programmed. The run is fully deterministic.
+*/
+
+#define SIM_DEFINE_REGISTERS
+#include "grbl.h"
+#include "simulator.h"
+#include "step_trace.h"
+#include <time.h>
+
+sim_t sim;
+
+// Interrupt service routines are defined by the firmware only when their feature is compiled in.
+extern void PCINT0_vect(void) __attribute__((weak));
+extern void PCINT2_vect(void) __attribute__((weak));
+extern void WDT_vect(void) __attribute__((weak));
+extern void TIMER1_COMPA_vect(void) __attribute__((weak));
+extern void TIMER0_COMPA_vect(void) __attribute__((weak));
+extern void TIMER0_OVF_vect(void) __attribute__((weak));
+extern void USART0_RX_vect(void) __attribute__((weak));
+extern void USART0_UDRE_vect(void) __attribute__((weak));
+extern void TIMER3_OVF_vect(void) __attribute__((weak));
+extern void TIMER5_OVF_vect(void) __attribute__((weak));
+
+// Firmware serial ring buffers, used for flow control and to detect the end of a job.
+extern uint8_t serial_rx_buffer_head;
+extern volatile uint8_t serial_rx_buffer_tail;
+extern uint8_t serial_tx_buffer_head;
+extern volatile uint8_t serial_tx_buffer_tail;
+
+typedef struct {
+  uint64_t anchor_time;   // Virtual time at which the counter held anchor_count
+  uint32_t anchor_count;
+  uint16_t prescaler;     // Zero while the timer clock is stopped
+  uint16_t tcnt_shadow;   // Counter value last published to TCNTn. A difference means a firmware write.
+  uint8_t tccrb_shadow;
+  uint16_t ocr_shadow;
+} sim_timer_t;
+
+static sim_timer_t t0, t1, t3, t5;
+static uint64_t t1_match_time, t0_ovf_time, t0_compa_time, t3_ovf_time, t5_ovf_time;
+
+// Timer5 output compare units A, B and C, driving OC5A, OC5B and OC5C on PL3, PL4 and PL5.
+#define SIM_OC5_CHANNELS 3
+#define SIM_OC5_PIN_SHIFT 3
+static volatile uint8_t tccr5a, tccr5c;
+static volatile uint16_t *const t5_ocr[SIM_OC5_CHANNELS] = { &OCR5A, &OCR5B, &OCR5C };
+static uint16_t t5_ocr_shadow[SIM_OC5_CHANNELS];
+static uint8_t tccr5a_shadow;
+static uint8_t t5_oc_levels; // Output compare pin levels, one bit per channel
+static uint64_t t5_oc_time[SIM_OC5_CHANNELS];
+
+static uint8_t eeprom[E2END+1];
+static volatile uint8_t eeprom_data;
+
+static uint64_t uart_rx_time, uart_tx_time, uart_rx_last;
+static uint8_t uart_tx_empty;
+static uint8_t host_connected; // Like a sender, the host waits for Grbl to start its main loop.
+
+static uint8_t in_sim; // Guards against synchronizing from within the simulator itself.
+
+static struct timespec realtime_start;
+
+
+static uint16_t sim_prescaler(uint8_t tccrb)
+{
+  switch (tccrb & 0x07) {
+    case 1: return(1);
+    case 2: return(8);
+    case 3: return(64);
+    case 4: return(256);
+    case 5: return(1024);
+  }
+  return(0); // Stopped or external clock source.
+}
+
+
+static uint32_t sim_timer_count(sim_timer_t *t, uint64_t now)
+{
+  if (!t->prescaler) { return(t->anchor_count); }
+  return(t->anchor_count + (uint32_t)((now - t->anchor_time)/t->prescaler));
+}
+
+
+static void sim_timer_anchor(sim_timer_t *t, uint64_t now, uint32_t count, uint8_t tccrb)
+{
+  t->anchor_time = now;
+  t->anchor_count = count;
+  t->tccrb_shadow = tccrb;
+  t->prescaler = sim_prescaler(tccrb);
+}
+
+
+// Time at which a counter starting from the anchor next steps past 'top', wrapping at 'size'.
+static uint64_t sim_timer_event(sim_timer_t *t, uint32_t top, uint32_t size)
+{
+  if (!t->prescaler) { return(SIM_NEVER); }
+  uint32_t ticks;
+  if (t->anchor_count <= top) { ticks = top - t->anchor_count + 1; }
+  else { ticks = size - t->anchor_count + top + 1; }
+  return(t->anchor_time + (uint64_t)ticks*t->prescaler);
+}
+
+
+// Cycles between events of a running counter that wraps after 'top'.
+static uint64_t sim_timer_period(sim_timer_t *t, uint32_t top) { return((uint64_t)(top+1)*t->prescaler); }
+
+
+uint32_t sim_uart_char_cycles()
+{
+  if (sim.baud_rate) { return((uint32_t)(10*(uint64_t)F_CPU/sim.baud_rate)); }
+  uint32_t ubrr = ((uint16_t)UBRR0H << 8) | UBRR0L;
+  uint32_t div = (UCSR0A & (1<<U2X0)) ? 8 : 16;
+  return(10*div*(ubrr+1)); // One start, eight data and one stop bit.
+}
+
+
+static uint8_t sim_rx_ring_room()
+{
+  uint8_t head = serial_rx_buffer_head;
+  uint8_t tail = serial_rx_buffer_tail;
+  if (head >= tail) { return(RX_BUFFER_SIZE - (head-tail)); }
+  return(tail-head-1);
+}
+
+
+// Realtime commands are picked off by the RX interrupt and never stored in the ring.
+static uint8_t sim_realtime_command(uint8_t data)
+{
+  if (data > 0x7F) { return(true); }
+  return((data == CMD_RESET) || (data == CMD_STATUS_REPORT) || (data == CMD_CYCLE_START) || (data == CMD_FEED_HOLD));
+}
+
+
+volatile uint8_t *sim_eeprom_data_register(void)
+{
+  if (EECR & (1<<EERE)) {
+    eeprom_data = eeprom[EEAR & E2END];
+    EECR &= ~(1<<EERE);
+  }
+  return(&eeprom_data);
+}
+
+
+// Completes a programming operation started by eeprom_put_char(). Returns its duration.
+static uint32_t sim_eeprom_program()
+{
+  if (!(EECR & (1<<EEPE))) { return(0); }
+  uint16_t addr = EEAR & E2END;
+  uint32_t cycles = SIM_EEPROM_SPLIT_CYCLES;
+  switch ((EECR >> 4) & 0x03) { // EEPM1:0
+    case 0: eeprom[addr] = eeprom_data; cycles = SIM_EEPROM_ERASE_WRITE_CYCLES; break;
+    case 1: eeprom[addr] = 0xff; break;
+    case 2: eeprom[addr] &= eeprom_data; break;
+  }
+  EECR &= ~((1<<EEPE) | (1<<EEMPE));
+  return(cycles);
+}
+
+
+// Compare output mode (COM5x1:0) of Timer5 channel 'ch', where 0 is A, 1 is B and 2 is C.
+static uint8_t sim_timer5_output_mode(uint8_t ch) { return((tccr5a >> (COM5A0-2*ch)) & 0x03); }
+
+
+// Output compare pin level after a compare match, or a forced one, on channel 'ch'.
+static uint8_t sim_timer5_output_compare(uint8_t ch)
+{
+  switch (sim_timer5_output_mode(ch)) {
+    case 1: return(t5_oc_levels ^ (1<<ch)); // Toggle
+    case 2: return(t5_oc_levels & ~(1<<ch)); // Clear
+    case 3: return(t5_oc_levels | (1<<ch)); // Set
+  }
+  return(t5_oc_levels); // Disconnected
+}
+
+
+// Applies a force output compare strobe written to TCCR5C. The FOC5x bits always read as zero.
+static void sim_timer5_force()
+{
+  uint8_t ch;
+  for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+    if (tccr5c & (1<<(FOC5A-ch))) { t5_oc_levels = sim_timer5_output_compare(ch); }
+  }
+  tccr5c &= ~((1<<FOC5A) | (1<<FOC5B) | (1<<FOC5C));
+}
+
+
+volatile uint8_t *sim_timer5_control_register(uint8_t reg)
+{
+  sim_timer5_force();
+  return(reg ? &tccr5c : &tccr5a);
+}
+
+
+// True while a connected output compare pin waits on a match that changes its level.
+static uint8_t sim_timer5_output_pending()
+{
+  uint8_t ch;
+  for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+    if (sim_timer5_output_compare(ch) != t5_oc_levels) { return(true); }
+  }
+  return(false);
+}
+
+
+// Publishes the pin levels. Connected output compare units drive their pins instead of PORTL.
+static void sim_update_pins()
+{
+  // Unconnected input pins read back their pull-up state.
+  PINA = PORTA; PINB = PORTB; PINC = PORTC; PIND = PORTD; PINE = PORTE; PINF = PORTF;
+  PING = PORTG; PINH = PORTH; PINJ = PORTJ; PINK = PORTK; PINL = PORTL;
+
+  uint8_t ch;
+  for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+    if (!sim_timer5_output_mode(ch)) { continue; }
+    uint8_t pin = 1<<(SIM_OC5_PIN_SHIFT+ch);
+    if (t5_oc_levels & (1<<ch)) { PINL |= pin; } else { PINL &= ~pin; }
+  }
+}
+
+
+// Picks up register writes made by the firmware since the last synchronization point.
+static void sim_sync_registers(uint64_t now)
+{
+  uint32_t count;
+
+  // Timer1: CTC mode with TOP = OCR1A.
+  if ((TCCR1B != t1.tccrb_shadow) || (OCR1A != t1.ocr_shadow) || (TCNT1 != t1.tcnt_shadow)) {
+    count = (TCNT1 != t1.tcnt_shadow) ? TCNT1 : (sim_timer_count(&t1, now) & 0xffff);
+    sim_timer_anchor(&t1, now, count, TCCR1B);
+    t1.ocr_shadow = OCR1A;
+    t1_match_time = sim_timer_event(&t1, OCR1A, 0x10000);
+  }
+  t1.tcnt_shadow = TCNT1 = (uint16_t)sim_timer_count(&t1, now);
+
+  // Timer0: normal mode, overflow at 0xFF and compare match A.
+  if ((TCCR0B != t0.tccrb_shadow) || (OCR0A != t0.ocr_shadow) || (TCNT0 != t0.tcnt_shadow)) {
+    count = (TCNT0 != t0.tcnt_shadow) ? TCNT0 : (sim_timer_count(&t0, now) & 0xff);
+    sim_timer_anchor(&t0, now, count, TCCR0B);
+    t0.ocr_shadow = OCR0A;
+    t0_ovf_time = sim_timer_event(&t0, 0xff, 0x100);
+    t0_compa_time = (OCR0A ? sim_timer_event(&t0, OCR0A-1, 0x100) : t0_ovf_time);
+  }
+  t0.tcnt_shadow = TCNT0 = (uint8_t)sim_timer_count(&t0, now);
+
+  // Timer3: normal mode, overflow at 0xFFFF. Used by the sleep counter.
+  if ((TCCR3B != t3.tccrb_shadow) || (TCNT3 != t3.tcnt_shadow)) {
+    count = (TCNT3 != t3.tcnt_shadow) ? TCNT3 : (sim_timer_count(&t3, now) & 0xffff);
+    sim_timer_anchor(&t3, now, count, TCCR3B);
+    t3_ovf_time = sim_timer_event(&t3, 0xffff, 0x10000);
+  }
+  t3.tcnt_shadow = TCNT3 = (uint16_t)sim_timer_count(&t3, now);
+
+  // Timer5: normal mode, overflow at 0xFFFF. Free-running profiling clock, and its output compare
+  // units end the step pulses with STEP_PULSE_OUTPUT_COMPARE.
+  sim_timer5_force();
+  uint8_t t5_changed = (tccr5a != tccr5a_shadow);
+  uint8_t ch;
+  for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+    if (*t5_ocr[ch] != t5_ocr_shadow[ch]) { t5_changed = true; }
+  }
+  if (t5_changed || (TCCR5B != t5.tccrb_shadow) || (TCNT5 != t5.tcnt_shadow)) {
+    count = (TCNT5 != t5.tcnt_shadow) ? TCNT5 : (sim_timer_count(&t5, now) & 0xffff);
+    sim_timer_anchor(&t5, now, count, TCCR5B);
+    t5_ovf_time = sim_timer_event(&t5, 0xffff, 0x10000);
+    tccr5a_shadow = tccr5a;
+    for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+      t5_ocr_shadow[ch] = *t5_ocr[ch];
+      t5_oc_time[ch] = SIM_NEVER;
+      if (sim_timer5_output_mode(ch)) { t5_oc_time[ch] = sim_timer_event(&t5, (uint16_t)(t5_ocr_shadow[ch]-1), 0x10000); }
+    }
+  }
+  t5.tcnt_shadow = TCNT5 = (uint16_t)sim_timer_count(&t5, now);
+
+  // UART receiver: schedule the next byte from the host once the previous one has been taken.
+  if (host_connected && (uart_rx_time == SIM_NEVER) && (UCSR0B & (1<<RXEN0)) && !(UCSR0A & (1<<RXC0))) {
+    if (sim.rx_poll && (sim.rx_poll() >= 0) && (!sim.rx_flow_control || sim_rx_ring_room())) {
+      uart_rx_time = uart_rx_last + sim_uart_char_cycles();
+      if (uart_rx_time < now) { uart_rx_time = now; }
+    }
+  }
+
+  sim_update_pins();
+  step_trace_sample(now); // Pin writes by the main program, like st_reset().
+}
+
+
+// Returns the highest priority interrupt that is flagged and enabled, or -1 if none.
+static int8_t sim_pending_vector()
+{
+  if ((TIFR1 & (1<<OCF1A)) && (TIMSK1 & (1<<OCIE1A))) { return(SIM_VECTOR_TIMER1_COMPA); }
+  if ((TIFR0 & (1<<OCF0A)) && (TIMSK0 & (1<<OCIE0A))) { return(SIM_VECTOR_TIMER0_COMPA); }
+  if ((TIFR0 & (1<<TOV0)) && (TIMSK0 & (1<<TOIE0))) { return(SIM_VECTOR_TIMER0_OVF); }
+  if ((UCSR0A & (1<<RXC0)) && (UCSR0B & (1<<RXCIE0))) { return(SIM_VECTOR_USART0_RX); }
+  if (uart_tx_empty && (UCSR0B & (1<<UDRIE0))) { return(SIM_VECTOR_USART0_UDRE); }
+  if ((TIFR3 & (1<<TOV3)) && (TIMSK3 & (1<<TOIE3))) { return(SIM_VECTOR_TIMER3_OVF); }
+  if ((TIFR5 & (1<<TOV5)) && (TIMSK5 & (1<<TOIE5))) { return(SIM_VECTOR_TIMER5_OVF); }
+  return(-1);
+}
+
+
+// Services an interrupt as the CPU would: clear its flag, disable interrupts, call, RETI.
+static void sim_service(int8_t vector)
+{
+  void (*isr)(void) = NULL;
+  switch (vector) {
+    case SIM_VECTOR_TIMER1_COMPA: TIFR1 &= ~(1<<OCF1A); isr = TIMER1_COMPA_vect; break;
+    case SIM_VECTOR_TIMER0_COMPA: TIFR0 &= ~(1<<OCF0A); isr = TIMER0_COMPA_vect; break;
+    case SIM_VECTOR_TIMER0_OVF: TIFR0 &= ~(1<<TOV0); isr = TIMER0_OVF_vect; break;
+    case SIM_VECTOR_USART0_RX: isr = USART0_RX_vect; break;
+    case SIM_VECTOR_USART0_UDRE: isr = USART0_UDRE_vect; break;
+    case SIM_VECTOR_TIMER3_OVF: TIFR3 &= ~(1<<TOV3); isr = TIMER3_OVF_vect; break;
+    case SIM_VECTOR_TIMER5_OVF: TIFR5 &= ~(1<<TOV5); isr = TIMER5_OVF_vect; break;
+  }
+  sim.isr_count[vector]++;
+  SREG &= ~(1<<SREG_I);
+  sim.isr_depth++;
+  if (isr) { isr(); }
+  sim.isr_depth--;
+  sim_update_pins();
+  step_trace_sample(sim.cycles);
+  SREG |= (1<<SREG_I);
+
+  if (vector == SIM_VECTOR_USART0_RX) {
+    UCSR0A &= ~(1<<RXC0); // Reading UDR0 clears the receive flag.
+  } else if (vector == SIM_VECTOR_USART0_UDRE) {
+    if (sim.tx_write) { sim.tx_write(UDR0); }
+    uart_tx_empty = false;
+    uart_tx_time = sim.cycles + sim_uart_char_cycles();
+  }
+}
+
+
+void sim_run_until(uint64_t target)
+{
+  uint8_t ch;
+  for (;;) {
+    sim_sync_registers(sim.cycles);
+
+    if (SREG & (1<<SREG_I)) {
+      int8_t vector = sim_pending_vector();
+      if (vector >= 0) {
+        sim_service(vector);
+        continue;
+      }
+    }
+
+    // Find the next hardware event. Ties resolve in interrupt priority order.
+    uint64_t next = t1_match_time;
+    if (t0_compa_time < next) { next = t0_compa_time; }
+    if (t0_ovf_time < next) { next = t0_ovf_time; }
+    if (uart_rx_time < next) { next = uart_rx_time; }
+    if (uart_tx_time < next) { next = uart_tx_time; }
+    if (t3_ovf_time < next) { next = t3_ovf_time; }
+    if (t5_ovf_time < next) { next = t5_ovf_time; }
+    for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+      if (t5_oc_time[ch] < next) { next = t5_oc_time[ch]; }
+    }
+    if (next > target) { break; }
+    if (next > sim.cycles) { sim.cycles = next; }
+
+    if (t1_match_time == next) {
+      TIFR1 |= (1<<OCF1A);
+      // CTC clears the counter on match. While the interrupt is masked, skip ahead to the last
+      // match before the target instead of stepping through every period of an idle timer.
+      uint64_t period = sim_timer_period(&t1, OCR1A);
+      uint64_t at = next;
+      if (!(TIMSK1 & (1<<OCIE1A))) { at += ((target-next)/period)*period; }
+      sim_timer_anchor(&t1, at, 0, TCCR1B);
+      t1_match_time = sim_timer_event(&t1, OCR1A, 0x10000);
+    }
+    if (t0_compa_time == next) {
+      TIFR0 |= (1<<OCF0A);
+      t0_compa_time += 0x100*(uint64_t)t0.prescaler;
+    }
+    if (t0_ovf_time == next) {
+      TIFR0 |= (1<<TOV0);
+      sim_timer_anchor(&t0, next, 0, TCCR0B);
+      t0_ovf_time = sim_timer_event(&t0, 0xff, 0x100);
+    }
+    if (t3_ovf_time == next) {
+      TIFR3 |= (1<<TOV3);
+      uint64_t period = sim_timer_period(&t3, 0xffff);
+      uint64_t at = next;
+      if (!(TIMSK3 & (1<<TOIE3))) { at += ((target-next)/period)*period; }
+      sim_timer_anchor(&t3, at, 0, TCCR3B);
+      t3_ovf_time = sim_timer_event(&t3, 0xffff, 0x10000);
+    }
+    if (t5_ovf_time == next) {
+      TIFR5 |= (1<<TOV5);
+      uint64_t period = sim_timer_period(&t5, 0xffff);
+      uint64_t at = next;
+      if (!(TIMSK5 & (1<<TOIE5))) { at += ((target-next)/period)*period; }
+      sim_timer_anchor(&t5, at, 0, TCCR5B);
+      t5_ovf_time = sim_timer_event(&t5, 0xffff, 0x10000);
+    }
+    for (ch=0; ch<SIM_OC5_CHANNELS; ch++) {
+      if (t5_oc_time[ch] != next) { continue; }
+      // A match that leaves its pin unchanged repeats unnoticed. Skip ahead, like an idle timer.
+      uint64_t period = sim_timer_period(&t5, 0xffff);
+      uint8_t levels = sim_timer5_output_compare(ch);
+      if (levels == t5_oc_levels) { t5_oc_time[ch] += ((target-next)/period)*period; }
+      t5_oc_levels = levels;
+      t5_oc_time[ch] += period;
+    }
+    if (uart_rx_time == next) {
+      int data = sim.rx_poll();
+      uart_rx_time = SIM_NEVER;
+      if (data >= 0) {
+        sim.rx_consume();
+        if (!sim_rx_ring_room() && !sim_realtime_command(data)) { sim.rx_overruns++; }
+        UDR0 = (uint8_t)data;
+        UCSR0A |= (1<<RXC0);
+        uart_rx_last = next;
+      }
+    }
+    if (uart_tx_time == next) {
+      uart_tx_empty = true;
+      uart_tx_time = SIM_NEVER;
+    }
+  }
+  if (target > sim.cycles) { sim.cycles = target; }
+}
+
+
+// Keeps virtual time from running ahead of the wall clock in real time mode.
+static void sim_pace()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  int64_t wall = (int64_t)(now.tv_sec - realtime_start.tv_sec)*1000000000 + (now.tv_nsec - realtime_start.tv_nsec);
+  int64_t ahead = (int64_t)(sim.cycles*1000/(F_CPU/1000000)) - wall;
+  if (ahead > SIM_REALTIME_SLACK_NSEC) {
+    struct timespec delay = { ahead/1000000000, ahead%1000000000 };
+    nanosleep(&delay, NULL);
+  } else if ((ahead < 0) && ((uint64_t)-ahead > sim.realtime_lag_max)) {
+    sim.realtime_lag_max = -ahead;
+  }
+}
+
+
+// Common synchronization point. Charges the given cost plus any EEPROM programming time.
+static void sim_sync(uint32_t cycles)
+{
+  cycles += sim_eeprom_program();
+  sim_run_until(sim.cycles + cycles);
+  if (sim.realtime) { sim_pace(); }
+  if (sim.cycles > sim.cycle_limit) {
+    fprintf(stderr, "sim: virtual time limit reached\n");
+    exit(2);
+  }
+}
+
+
+static uint8_t sim_tx_ring_full()
+{
+  uint8_t next_head = serial_tx_buffer_head + 1;
+  if (next_head == TX_BUFFER_SIZE+1) { next_head = 0; }
+  return(next_head == serial_tx_buffer_tail);
+}
+
+
+// The job is complete when all input has been received and executed and all output sent.
+static uint8_t sim_job_complete()
+{
+  if (!sim.rx_poll || (sim.rx_poll() != SIM_RX_EOF)) { return(false); }
+  if (serial_rx_buffer_head != serial_rx_buffer_tail) { return(false); }
+  if (serial_tx_buffer_head != serial_tx_buffer_tail) { return(false); }
+  if (!uart_tx_empty) { return(false); }
+  if (TCCR0B & 0x07) { return(false); } // The last step pulse has not ended yet.
+  if (sim_timer5_output_pending()) { return(false); } // Likewise, with STEP_PULSE_OUTPUT_COMPARE.
+  if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_HOMING | STATE_JOG | STATE_SAFETY_DOOR)) { return(false); }
+  return(plan_get_current_block() == NULL);
+}
+
+
+void __cyg_profile_func_enter(void *this_fn, void *call_site)
+{
+  // Calls made by interrupt service routines, or by the simulator itself, are free.
+  if (in_sim) { return; }
+  in_sim = true;
+  if (sim.passive) {
+    // No UART either. Discard any pending output so serial_write() never waits on it.
+    if (this_fn == (void *)serial_write) { serial_tx_buffer_tail = serial_tx_buffer_head; }
+    if (sim.on_call) { sim.on_call(this_fn, true); }
+    in_sim = false;
+    return;
+  }
+  if (this_fn == (void *)serial_read) {
+    host_connected = true;
+    // Grbl is idle between lines. Exit once the whole job has been streamed and executed.
+    if (sim_job_complete()) {
+      if (sim.on_exit) { sim.on_exit(); }
+      exit(0);
+    }
+  } else if (this_fn == (void *)serial_write) {
+    // serial_write() spins without a function call while the TX ring is full. Let the UART
+    // drain it here, in the virtual time the spin would have taken.
+    while (sim_tx_ring_full() && (uart_tx_time != SIM_NEVER)) { sim_run_until(uart_tx_time); }
+  }
+  sim_sync(sim.cycles_per_call);
+  if (sim.on_call) { sim.on_call(this_fn, true); }
+  in_sim = false;
+}
+
+
+void __cyg_profile_func_exit(void *this_fn, void *call_site)
+{
+  if (in_sim || !sim.on_call) { return; }
+  in_sim = true;
+  sim.on_call(this_fn, false);
+  in_sim = false;
+}
+
+
+void sim_sei(void)
+{
+  SREG |= (1<<SREG_I);
+  if (!in_sim && !sim.passive) {
+    in_sim = true;
+    sim_sync(0);
+    in_sim = false;
+  }
+}
+
+
+void sim_cli(void)
+{
+  if (!in_sim && !sim.passive) {
+    in_sim = true;
+    sim_sync(0);
+    in_sim = false;
+  }
+  SREG &= ~(1<<SREG_I);
+}
+
+
+void sim_delay_cycles(uint32_t cycles)
+{
+  if (sim.passive) { return; }
+  uint8_t nested = in_sim;
+  in_sim = true;
+  sim_sync(cycles);
+  in_sim = nested;
+}
+
+
+void sim_init()
+{
+  if (!sim.cycles_per_call) { sim.cycles_per_call = SIM_DEFAULT_CYCLES_PER_CALL; }
+  if (!sim.cycle_limit) { sim.cycle_limit = SIM_NEVER; }
+  sim.cycles = 0;
+  t1_match_time = t0_ovf_time = t0_compa_time = t3_ovf_time = t5_ovf_time = SIM_NEVER;
+  t5_oc_time[0] = t5_oc_time[1] = t5_oc_time[2] = SIM_NEVER;
+  uart_rx_time = uart_tx_time = SIM_NEVER;
+  uart_rx_last = 0;
+  uart_tx_empty = true;
+  host_connected = false;
+  UCSR0A = (1<<UDRE0);
+  clock_gettime(CLOCK_MONOTONIC, &realtime_start);
+}
+
+
+uint8_t sim_eeprom_load(const char *filename)
+{
+  memset(eeprom, 0xff, sizeof(eeprom)); // Erased state.
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) { return(false); }
+  size_t n = fread(eeprom, 1, sizeof(eeprom), fp);
+  fclose(fp);
+  return(n == sizeof(eeprom));
+}
+
+
+uint8_t sim_eeprom_save(const char *filename)
+{
+  FILE *fp = fopen(filename, "wb");
+  if (fp == NULL) { return(false); }
+  size_t n = fwrite(eeprom, 1, sizeof(eeprom), fp);
+  fclose(fp);
+  return(n == sizeof(eeprom));
+}
+
+
+void sim_report(FILE *stream, double host_seconds)
+{
+  double seconds = (double)sim.cycles/F_CPU;
+  fprintf(stream, "sim: %.6f s virtual, %.3f s host", seconds, host_seconds);
+  if (host_seconds > 0.0) { fprintf(stream, " (%.1fx real time)", seconds/host_seconds); }
+  fprintf(stream, "\nsim: isr timer1_compa %llu, timer0_ovf %llu, usart0_rx %llu, usart0_udre %llu\n",
+    (unsigned long long)sim.isr_count[SIM_VECTOR_TIMER1_COMPA],
+    (unsigned long long)sim.isr_count[SIM_VECTOR_TIMER0_OVF],
+    (unsigned long long)sim.isr_count[SIM_VECTOR_USART0_RX],
+    (unsigned long long)sim.isr_count[SIM_VECTOR_USART0_UDRE]);
+  if (sim.rx_overruns) {
+    fprintf(stream, "sim: %llu bytes received while the RX buffer was full were lost\n",
+      (unsigned long long)sim.rx_overruns);
+  }
+  if (sim.realtime) {
+    fprintf(stream, "sim: fell behind real time by up to %.3f ms\n", 1e-6*sim.realtime_lag_max);
+  }
+}
@@ -0,0 +1,104 @@
+/*
+  simulator.h - virtual-time ATmega2560 model that runs Grbl on a host computer
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef simulator_h
+#define simulator_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_NEVER UINT64_MAX
+
+// Interrupt vectors modeled by the simulator, in ATmega2560 priority order (lowest vector
+// number first). Pending interrupts that come due at the same virtual time are serviced in
+// this order, as on hardware.
+#define SIM_VECTOR_PCINT0        0
+#define SIM_VECTOR_PCINT2        1
+#define SIM_VECTOR_WDT           2
+#define SIM_VECTOR_TIMER1_COMPA  3
+#define SIM_VECTOR_TIMER0_COMPA  4
+#define SIM_VECTOR_TIMER0_OVF    5
+#define SIM_VECTOR_USART0_RX     6
+#define SIM_VECTOR_USART0_UDRE   7
+#define SIM_VECTOR_TIMER3_OVF    8
+#define SIM_VECTOR_TIMER5_OVF    9
+#define SIM_N_VECTORS            10
+
+// Return values of the host serial receive callback.
+#define SIM_RX_NONE -1 // No byte available yet. Polled again at the next synchronization point.
+#define SIM_RX_EOF  -2 // Input is exhausted. The simulator exits once Grbl has finished the job.
+
+// Default cost, in CPU cycles, charged to virtual time for each firmware function call made
+// by the main program. Interrupt service routines execute in zero virtual time, so every ISR
+// fires exactly on its timer tick.
+#define SIM_DEFAULT_CYCLES_PER_CALL 60
+
+// EEPROM programming times from the ATmega2560 datasheet (3.4ms erase+write, 1.8ms split).
+#define SIM_EEPROM_ERASE_WRITE_CYCLES (F_CPU/1000*34/10)
+#define SIM_EEPROM_SPLIT_CYCLES (F_CPU/1000*18/10)
+
+// In real time mode, the simulator sleeps once virtual time runs this far ahead of the wall clock.
+#define SIM_REALTIME_SLACK_NSEC 1000000
+
+typedef struct {
+  uint64_t cycles;             // Virtual time since power-up in CPU cycles.
+  uint64_t cycle_limit;        // Stop the simulation after this virtual time. SIM_NEVER for none.
+  uint32_t cycles_per_call;    // Main program cost model. See SIM_DEFAULT_CYCLES_PER_CALL.
+  uint32_t baud_rate;          // Modeled UART baud rate. Zero derives it from UBRR0 as programmed.
+  uint8_t rx_flow_control;     // Only deliver a byte when Grbl's RX ring has room for it.
+  uint8_t realtime;            // Hold virtual time back to the wall clock, for a host on a real terminal.
+  uint8_t passive;             // Firmware calls no longer advance time or service interrupts. Output is dropped.
+  uint8_t isr_depth;           // Nesting level of interrupt service routines currently executing.
+  uint64_t isr_count[SIM_N_VECTORS]; // Number of times each vector has been serviced.
+  uint64_t rx_overruns;        // Bytes delivered while Grbl's RX ring was full, and so dropped.
+  uint64_t realtime_lag_max;   // Furthest virtual time has fallen behind the wall clock, in nsec.
+
+  // Host side of the virtual UART. rx_poll() returns the next byte without consuming it.
+  int (*rx_poll)(void);
+  void (*rx_consume)(void);
+  void (*tx_write)(uint8_t data);
+
+  // Called once when the job is complete, just before the process exits.
+  void (*on_exit)(void);
+
+  // Called on entry (enter = 1) and exit (enter = 0) of every firmware function called by the
+  // main program. Used by host tools to profile firmware routines.
+  void (*on_call)(void *fn, uint8_t enter);
+} sim_t;
+extern sim_t sim;
+
+// Grbl's own main(), renamed at compile time.
+int avr_main(void);
+
+// Resets the modeled hardware to its power-up state.
+void sim_init();
+
+// Advances virtual time to the target cycle count, firing every interrupt that comes due.
+void sim_run_until(uint64_t target);
+
+// Returns the modeled UART character time in CPU cycles.
+uint32_t sim_uart_char_cycles();
+
+// Loads and saves the 4KB EEPROM image. Returns zero if the file could not be read or written.
+uint8_t sim_eeprom_load(const char *filename);
+uint8_t sim_eeprom_save(const char *filename);
+
+// Prints virtual time and interrupt statistics.
+void sim_report(FILE *stream, double host_seconds);
+
+#endif
@@ -0,0 +1,89 @@
+/*
+  step_trace.c - records the step and direction pin edges of the simulated stepper
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+#include "step_trace.h"
+
+#if N_AXIS > STEP_TRACE_MAX_AXES
+  #error "Step trace records at most 4 axes."
+#endif
+
+static FILE *trace;
+static uint8_t last_pins;
+static uint64_t last_time;
+
+
+// Gathers the step and direction pin levels of all axes into the trace pin byte. Reads the PINx
+// registers, since an output compare unit may drive a step pin instead of its PORTx bit.
+static uint8_t step_trace_pins()
+{
+  uint8_t pins = 0;
+  #ifdef DEFAULTS_RAMPS_BOARD
+    if (STEP_PIN(0) & (1<<STEP_BIT(0))) { pins |= (1<<X_AXIS); }
+    if (STEP_PIN(1) & (1<<STEP_BIT(1))) { pins |= (1<<Y_AXIS); }
+    if (STEP_PIN(2) & (1<<STEP_BIT(2))) { pins |= (1<<Z_AXIS); }
+    if (DIRECTION_PIN(0) & (1<<DIRECTION_BIT(0))) { pins |= (1<<(X_AXIS+STEP_TRACE_DIR_SHIFT)); }
+    if (DIRECTION_PIN(1) & (1<<DIRECTION_BIT(1))) { pins |= (1<<(Y_AXIS+STEP_TRACE_DIR_SHIFT)); }
+    if (DIRECTION_PIN(2) & (1<<DIRECTION_BIT(2))) { pins |= (1<<(Z_AXIS+STEP_TRACE_DIR_SHIFT)); }
+  #else
+    if (STEP_PIN & (1<<X_STEP_BIT)) { pins |= (1<<X_AXIS); }
+    if (STEP_PIN & (1<<Y_STEP_BIT)) { pins |= (1<<Y_AXIS); }
+    if (STEP_PIN & (1<<Z_STEP_BIT)) { pins |= (1<<Z_AXIS); }
+    if (DIRECTION_PIN & (1<<X_DIRECTION_BIT)) { pins |= (1<<(X_AXIS+STEP_TRACE_DIR_SHIFT)); }
+    if (DIRECTION_PIN & (1<<Y_DIRECTION_BIT)) { pins |= (1<<(Y_AXIS+STEP_TRACE_DIR_SHIFT)); }
+    if (DIRECTION_PIN & (1<<Z_DIRECTION_BIT)) { pins |= (1<<(Z_AXIS+STEP_TRACE_DIR_SHIFT)); }
+  #endif
+  return(pins);
+}
+
+
+void step_trace_open(FILE *stream)
+{
+  trace = stream;
+  last_pins = 0;
+  last_time = 0;
+  fwrite(STEP_TRACE_MAGIC, 1, STEP_TRACE_MAGIC_SIZE, trace);
+  putc(N_AXIS, trace);
+}
+
+
+void step_trace_sample(uint64_t now)
+{
+  if (trace == NULL) { return; }
+  uint8_t pins = step_trace_pins();
+  if (pins == last_pins) { return; }
+  uint64_t delta = now - last_time;
+  while (delta >= 0x80) {
+    putc((delta & 0x7f) | 0x80, trace);
+    delta >>= 7;
+  }
+  putc(delta, trace);
+  putc(pins, trace);
+  last_pins = pins;
+  last_time = now;
+}
+
+
+uint8_t step_trace_close()
+{
+  if (trace == NULL) { return(true); }
+  uint8_t ok = !ferror(trace);
+  if (fclose(trace) != 0) { ok = false; }
+  trace = NULL;
+  return(ok);
+}
@@ -0,0 +1,52 @@
+/*
+  step_trace.h - records the step and direction pin edges of the simulated stepper
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef step_trace_h
+#define step_trace_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Trace file format. All values are little endian.
+
+     header   "GRBLSTP" 0x01, then one byte with the number of axes.
+     record   Virtual time since the previous record, in CPU cycles, as an unsigned LEB128
+              varint (7 bits per byte, low bits first, high bit set on all but the last byte),
+              followed by one byte with the new pin levels: bit n is the step pin of axis n and
+              bit n+4 its direction pin.
+
+   The first record is relative to power-up. A record is written whenever any of the pins
+   changes, so a step pulse costs two records of typically two or three bytes each. Pin levels
+   are recorded as driven, after Grbl's invert masks have been applied. */
+
+#define STEP_TRACE_MAGIC "GRBLSTP\x01"
+#define STEP_TRACE_MAGIC_SIZE 8
+#define STEP_TRACE_DIR_SHIFT 4
+#define STEP_TRACE_MAX_AXES 4
+
+// Starts recording to an open binary stream. Writes the header.
+void step_trace_open(FILE *stream);
+
+// Samples the step and direction pins at the given virtual time. Called by the simulator after
+// every interrupt service routine and at every synchronization point of the main program.
+void step_trace_sample(uint64_t now);
+
+// Flushes and closes the trace. Returns zero on a write error.
+uint8_t step_trace_close();
+
+#endif
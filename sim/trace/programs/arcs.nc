@@ -0,0 +1,9 @@
+(Arcs and a helix with the default arc tolerance)
+G21 G90 G17 G94
+G0 X1 Y0
+G2 X-1 Y0 I-1 J0 F300
+G2 X1 Y0 I1 J0
+G3 X0 Y1 R1 F200
+G18 G2 X1 Z-0.5 I0.5 K-0.25 F150
+G17 G3 X1 Y0 Z0 I0 J-0.5 F250
+G0 X0 Y0 Z0
@@ -0,0 +1,10 @@
+(Slow and changing feed rates, which step at every AMASS level, and a dwell)
+G21 G90 G17 G94
+G1 X0.2 Y0.1 F10
+G1 X0.4 Y0.15 F30
+G1 X0.8 Y0.3 F60
+G1 X1.5 Y0.6 F120
+G1 X2.5 Y1.1 F240
+G4 P0.05
+G1 X0.5 Y0.9 Z-0.2 F80
+G1 X0 Y0 Z0 F500
@@ -0,0 +1,12 @@
+(Straight moves: single axis, diagonals, three axis moves and direction reversals)
+G21 G90 G17 G94
+G0 X2
+G0 Y-2
+G1 X4 Y1 F300
+G1 X1 Y2 Z-0.5 F400
+G1 X0 Y0 Z0 F250
+G91 G1 X1.5 F500
+G1 X-1.5 F500
+G1 Y0.8 Z0.3 F200
+G1 Y-0.8 Z-0.3 F200
+G90 G0 X0 Y0
@@ -0,0 +1,165 @@
+(Short segments along a spiral, as CAM output. Exercises planner look-ahead and junctions)
+G21 G90 G17 G94
+G0 X0 Y0
+F400
+G1 X0.008 Y0.040 Z-0.002
+G1 X0.014 Y0.081 Z-0.004
+G1 X0.015 Y0.124 Z-0.006
+G1 X0.014 Y0.167 Z-0.008
+G1 X0.008 Y0.210 Z-0.010
+G1 X-0.001 Y0.254 Z-0.012
+G1 X-0.014 Y0.298 Z-0.014
+G1 X-0.031 Y0.341 Z-0.016
+G1 X-0.051 Y0.383 Z-0.018
+G1 X-0.076 Y0.424 Z-0.020
+G1 X-0.104 Y0.464 Z-0.022
+G1 X-0.136 Y0.502 Z-0.024
+G1 X-0.171 Y0.537 Z-0.026
+G1 X-0.209 Y0.570 Z-0.028
+G1 X-0.251 Y0.601 Z-0.030
+G1 X-0.296 Y0.628 Z-0.032
+G1 X-0.344 Y0.651 Z-0.034
+G1 X-0.394 Y0.672 Z-0.036
+G1 X-0.446 Y0.688 Z-0.038
+G1 X-0.500 Y0.700 Z-0.040
+G1 X-0.556 Y0.708 Z-0.042
+G1 X-0.613 Y0.711 Z-0.044
+G1 X-0.670 Y0.710 Z-0.046
+G1 X-0.729 Y0.704 Z-0.048
+G1 X-0.787 Y0.693 Z-0.050
+G1 X-0.845 Y0.677 Z-0.052
+G1 X-0.902 Y0.657 Z-0.054
+G1 X-0.958 Y0.631 Z-0.056
+G1 X-1.013 Y0.601 Z-0.058
+G1 X-1.066 Y0.566 Z-0.060
+G1 X-1.116 Y0.526 Z-0.062
+G1 X-1.163 Y0.482 Z-0.064
+G1 X-1.208 Y0.434 Z-0.066
+G1 X-1.248 Y0.381 Z-0.068
+G1 X-1.285 Y0.325 Z-0.070
+G1 X-1.318 Y0.266 Z-0.072
+G1 X-1.346 Y0.203 Z-0.074
+G1 X-1.369 Y0.138 Z-0.076
+G1 X-1.387 Y0.070 Z-0.078
+G1 X-1.400 Y0.000 Z-0.080
+G1 X-1.407 Y-0.071 Z-0.082
+G1 X-1.409 Y-0.144 Z-0.084
+G1 X-1.404 Y-0.217 Z-0.086
+G1 X-1.394 Y-0.290 Z-0.088
+G1 X-1.378 Y-0.364 Z-0.090
+G1 X-1.355 Y-0.436 Z-0.092
+G1 X-1.327 Y-0.507 Z-0.094
+G1 X-1.293 Y-0.576 Z-0.096
+G1 X-1.253 Y-0.643 Z-0.098
+G1 X-1.207 Y-0.707 Z-0.100
+G1 X-1.156 Y-0.768 Z-0.102
+G1 X-1.100 Y-0.825 Z-0.104
+G1 X-1.038 Y-0.878 Z-0.106
+G1 X-0.972 Y-0.927 Z-0.108
+G1 X-0.902 Y-0.970 Z-0.110
+G1 X-0.828 Y-1.008 Z-0.112
+G1 X-0.750 Y-1.040 Z-0.114
+G1 X-0.669 Y-1.067 Z-0.116
+G1 X-0.586 Y-1.087 Z-0.118
+G1 X-0.500 Y-1.100 Z-0.120
+G1 X-0.413 Y-1.107 Z-0.122
+G1 X-0.325 Y-1.106 Z-0.124
+G1 X-0.236 Y-1.099 Z-0.126
+G1 X-0.148 Y-1.084 Z-0.128
+G1 X-0.060 Y-1.062 Z-0.130
+G1 X0.027 Y-1.034 Z-0.132
+G1 X0.111 Y-0.998 Z-0.134
+G1 X0.194 Y-0.955 Z-0.136
+G1 X0.273 Y-0.905 Z-0.138
+G1 X0.349 Y-0.849 Z-0.140
+G1 X0.420 Y-0.786 Z-0.142
+G1 X0.487 Y-0.717 Z-0.144
+G1 X0.549 Y-0.643 Z-0.146
+G1 X0.605 Y-0.563 Z-0.148
+G1 X0.655 Y-0.478 Z-0.150
+G1 X0.698 Y-0.389 Z-0.152
+G1 X0.735 Y-0.296 Z-0.154
+G1 X0.764 Y-0.200 Z-0.156
+G1 X0.786 Y-0.101 Z-0.158
+G1 X0.800 Y-0.000 Z-0.160
+G1 X0.806 Y0.103 Z-0.162
+G1 X0.804 Y0.206 Z-0.164
+G1 X0.793 Y0.310 Z-0.166
+G1 X0.774 Y0.414 Z-0.168
+G1 X0.747 Y0.517 Z-0.170
+G1 X0.712 Y0.617 Z-0.172
+G1 X0.668 Y0.716 Z-0.174
+G1 X0.616 Y0.811 Z-0.176
+G1 X0.557 Y0.903 Z-0.178
+G1 X0.490 Y0.990 Z-0.180
+G1 X0.416 Y1.072 Z-0.182
+G1 X0.335 Y1.149 Z-0.184
+G1 X0.247 Y1.219 Z-0.186
+G1 X0.154 Y1.283 Z-0.188
+G1 X0.055 Y1.340 Z-0.190
+G1 X-0.049 Y1.389 Z-0.192
+G1 X-0.157 Y1.429 Z-0.194
+G1 X-0.268 Y1.462 Z-0.196
+G1 X-0.383 Y1.485 Z-0.198
+G1 X-0.500 Y1.500 Z-0.200
+G1 X-0.618 Y1.505 Z-0.202
+G1 X-0.738 Y1.501 Z-0.204
+G1 X-0.857 Y1.488 Z-0.206
+G1 X-0.976 Y1.465 Z-0.208
+G1 X-1.093 Y1.432 Z-0.210
+G1 X-1.208 Y1.390 Z-0.212
+G1 X-1.320 Y1.339 Z-0.214
+G1 X-1.429 Y1.278 Z-0.216
+G1 X-1.533 Y1.209 Z-0.218
+G1 X-1.631 Y1.131 Z-0.220
+G1 X-1.724 Y1.046 Z-0.222
+G1 X-1.811 Y0.952 Z-0.224
+G1 X-1.890 Y0.852 Z-0.226
+G1 X-1.961 Y0.745 Z-0.228
+G1 X-2.024 Y0.631 Z-0.230
+G1 X-2.079 Y0.513 Z-0.232
+G1 X-2.124 Y0.390 Z-0.234
+G1 X-2.159 Y0.263 Z-0.236
+G1 X-2.185 Y0.133 Z-0.238
+G1 X-2.200 Y0.000 Z-0.240
+G1 X-2.205 Y-0.134 Z-0.242
+G1 X-2.199 Y-0.269 Z-0.244
+G1 X-2.182 Y-0.404 Z-0.246
+G1 X-2.155 Y-0.538 Z-0.248
+G1 X-2.117 Y-0.670 Z-0.250
+G1 X-2.068 Y-0.799 Z-0.252
+G1 X-2.009 Y-0.925 Z-0.254
+G1 X-1.940 Y-1.046 Z-0.256
+G1 X-1.861 Y-1.163 Z-0.258
+G1 X-1.773 Y-1.273 Z-0.260
+G1 X-1.676 Y-1.376 Z-0.262
+G1 X-1.570 Y-1.472 Z-0.264
+G1 X-1.456 Y-1.560 Z-0.266
+G1 X-1.335 Y-1.639 Z-0.268
+G1 X-1.208 Y-1.709 Z-0.270
+G1 X-1.075 Y-1.769 Z-0.272
+G1 X-0.937 Y-1.818 Z-0.274
+G1 X-0.794 Y-1.857 Z-0.276
+G1 X-0.648 Y-1.884 Z-0.278
+G1 X-0.500 Y-1.900 Z-0.280
+G1 X-0.350 Y-1.904 Z-0.282
+G1 X-0.200 Y-1.896 Z-0.284
+G1 X-0.049 Y-1.877 Z-0.286
+G1 X0.099 Y-1.845 Z-0.288
+G1 X0.246 Y-1.802 Z-0.290
+G1 X0.390 Y-1.746 Z-0.292
+G1 X0.529 Y-1.680 Z-0.294
+G1 X0.664 Y-1.602 Z-0.296
+G1 X0.792 Y-1.513 Z-0.298
+G1 X0.914 Y-1.414 Z-0.300
+G1 X1.028 Y-1.305 Z-0.302
+G1 X1.134 Y-1.187 Z-0.304
+G1 X1.231 Y-1.061 Z-0.306
+G1 X1.318 Y-0.926 Z-0.308
+G1 X1.394 Y-0.785 Z-0.310
+G1 X1.459 Y-0.637 Z-0.312
+G1 X1.513 Y-0.483 Z-0.314
+G1 X1.554 Y-0.325 Z-0.316
+G1 X1.584 Y-0.164 Z-0.318
+G1 X1.600 Y-0.000 Z-0.320
+G0 X0 Y0 Z0
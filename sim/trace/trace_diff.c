@@ -0,0 +1,194 @@
+/*
+  trace_diff.c - compares two step traces recorded by the Grbl host simulator
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Each step and direction pin is compared on its own, edge by edge, so a small timing change
+// on one axis does not throw off the comparison of the others. Two traces match when every pin
+// has the same number of edges and each edge lies within the tolerance of its counterpart.
+// Times are taken from the first step of each trace, so a change in start-up time is ignored.
+// Exits 0 when the traces match, 1 when they differ, and 2 on a read error.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../step_trace.h"
+
+#define N_SIGNAL (2*STEP_TRACE_MAX_AXES)
+
+typedef struct {
+  uint64_t *time;
+  uint32_t count;
+  uint32_t size;
+} edges_t;
+
+typedef struct {
+  uint8_t n_axis;
+  edges_t signal[N_SIGNAL]; // Step pins first, then direction pins, by axis.
+} trace_t;
+
+static const char axis_name[STEP_TRACE_MAX_AXES] = { 'X', 'Y', 'Z', 'A' };
+
+
+static void add_edge(edges_t *e, uint64_t time)
+{
+  if (e->count == e->size) {
+    e->size = e->size ? 2*e->size : 1024;
+    e->time = realloc(e->time, e->size*sizeof(uint64_t));
+    if (e->time == NULL) { perror("trace_diff"); exit(2); }
+  }
+  e->time[e->count++] = time;
+}
+
+
+static uint8_t load_trace(const char *filename, trace_t *t)
+{
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) { perror(filename); return(false); }
+  char magic[STEP_TRACE_MAGIC_SIZE];
+  int n_axis;
+  if ((fread(magic, 1, STEP_TRACE_MAGIC_SIZE, fp) != STEP_TRACE_MAGIC_SIZE) ||
+      memcmp(magic, STEP_TRACE_MAGIC, STEP_TRACE_MAGIC_SIZE) ||
+      ((n_axis = getc(fp)) < 1) || (n_axis > STEP_TRACE_MAX_AXES)) {
+    fprintf(stderr, "%s: not a step trace\n", filename);
+    fclose(fp);
+    return(false);
+  }
+  memset(t, 0, sizeof(trace_t));
+  t->n_axis = n_axis;
+
+  uint8_t pins = 0, axis;
+  uint64_t time = 0;
+  int c;
+  while ((c = getc(fp)) != EOF) {
+    uint64_t delta = 0;
+    uint8_t shift = 0;
+    while (c & 0x80) {
+      delta |= (uint64_t)(c & 0x7f) << shift;
+      shift += 7;
+      if (((c = getc(fp)) == EOF) || (shift > 63)) { break; }
+    }
+    int new_pins = (c == EOF) ? EOF : getc(fp);
+    if (new_pins == EOF) {
+      fprintf(stderr, "%s: truncated record\n", filename);
+      fclose(fp);
+      return(false);
+    }
+    time += delta | ((uint64_t)c << shift);
+    uint8_t changed = pins ^ new_pins;
+    for (axis = 0; axis < t->n_axis; axis++) {
+      if (changed & (1<<axis)) { add_edge(&t->signal[axis], time); }
+      if (changed & (1<<(axis+STEP_TRACE_DIR_SHIFT))) { add_edge(&t->signal[STEP_TRACE_MAX_AXES+axis], time); }
+    }
+    pins = new_pins;
+  }
+  fclose(fp);
+
+  // Rebase all edges to the first step.
+  uint64_t start = UINT64_MAX;
+  for (axis = 0; axis < t->n_axis; axis++) {
+    if (t->signal[axis].count && (t->signal[axis].time[0] < start)) { start = t->signal[axis].time[0]; }
+  }
+  if (start == UINT64_MAX) { return(true); }
+  uint8_t i;
+  uint32_t k;
+  for (i = 0; i < N_SIGNAL; i++) {
+    for (k = 0; k < t->signal[i].count; k++) { t->signal[i].time[k] -= start; }
+  }
+  return(true);
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [-t cycles] [-q] expected.trace actual.trace\n"
+    "Compares the step and direction pin edges of two step traces.\n"
+    "  -t cycles   Accept edges that are up to this many CPU cycles apart (default 0)\n"
+    "  -q          Only report differences\n",
+    name);
+}
+
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  uint64_t tolerance = 0;
+  uint8_t quiet = 0;
+  while ((opt = getopt(argc, argv, "t:qh")) != -1) {
+    switch (opt) {
+      case 't': tolerance = strtoull(optarg, NULL, 10); break;
+      case 'q': quiet = 1; break;
+      default: usage(argv[0]); return(opt == 'h' ? 0 : 2);
+    }
+  }
+  if (optind+2 != argc) { usage(argv[0]); return(2); }
+
+  static trace_t expected, actual;
+  if (!load_trace(argv[optind], &expected) || !load_trace(argv[optind+1], &actual)) { return(2); }
+  if (expected.n_axis != actual.n_axis) {
+    printf("%s: %d axes, expected %d\n", argv[optind+1], actual.n_axis, expected.n_axis);
+    return(1);
+  }
+
+  uint8_t differ = false;
+  uint64_t max_deviation = 0;
+  int i;
+  for (i = 0; i < N_SIGNAL; i++) {
+    uint8_t axis = i % STEP_TRACE_MAX_AXES;
+    if (axis >= expected.n_axis) { continue; }
+    const char *pin = (i < STEP_TRACE_MAX_AXES) ? "step" : "dir";
+    edges_t *e = &expected.signal[i];
+    edges_t *a = &actual.signal[i];
+    uint32_t n = (e->count < a->count) ? e->count : a->count;
+    uint32_t k, first_bad = n;
+    uint64_t deviation = 0;
+    for (k = 0; k < n; k++) {
+      uint64_t d = (e->time[k] > a->time[k]) ? e->time[k]-a->time[k] : a->time[k]-e->time[k];
+      if (d > deviation) { deviation = d; }
+      if ((d > tolerance) && (first_bad == n)) { first_bad = k; }
+    }
+    if (deviation > max_deviation) { max_deviation = deviation; }
+    if (first_bad < n) {
+      printf("%c %s: edge %lu at cycle %llu, expected %llu\n", axis_name[axis], pin,
+        (unsigned long)first_bad, (unsigned long long)a->time[first_bad],
+        (unsigned long long)e->time[first_bad]);
+      differ = true;
+    }
+    if (e->count != a->count) {
+      printf("%c %s: %lu edges, expected %lu. First extra or missing edge at cycle %llu\n",
+        axis_name[axis], pin, (unsigned long)a->count, (unsigned long)e->count,
+        (unsigned long long)((e->count > n) ? e->time[n] : a->time[n]));
+      differ = true;
+    }
+  }
+
+  if (differ) {
+    printf("%s: DIFFERENT from %s\n", argv[optind+1], argv[optind]);
+    return(1);
+  }
+  if (!quiet) {
+    printf("%s: ", argv[optind+1]);
+    for (i = 0; i < expected.n_axis; i++) {
+      printf("%c %lu steps, ", axis_name[i], (unsigned long)expected.signal[i].count/2);
+    }
+    if (max_deviation) { printf("match within %llu cycles\n", (unsigned long long)max_deviation); }
+    else { printf("identical\n"); }
+  }
+  return(0);
+}